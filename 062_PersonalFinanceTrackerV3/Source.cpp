@@ -4,6 +4,18 @@
 #include <memory>
 #include <vector>
 #include <unordered_map>
+#include <optional>
+#include <cstdint>
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
 
 // Enums
 enum class TransactionType { Income, Expense };
@@ -98,6 +110,10 @@ public:
     int getTransactionID() const override { return TransactionID; }
     double getAmount() const override { return Amount; }
     TransactionType getType() const override { return Type; }
+
+    int getUserID() const { return UserID; }
+    int getCategoryID() const { return CategoryID; }
+    const std::chrono::system_clock::time_point& getDate() const { return Date; }
 };
 
 // Category Class
@@ -121,36 +137,46 @@ public:
 class Budget : public IBudget {
 private:
     int BudgetID;
+    int UserID;
+    int CategoryID;
     double Amount;
     std::chrono::system_clock::time_point StartDate;
     std::chrono::system_clock::time_point EndDate;
 
 public:
-    Budget(int budgetID, double amount,
+    Budget(int budgetID, int userID, int categoryID, double amount,
         const std::chrono::system_clock::time_point& startDate,
         const std::chrono::system_clock::time_point& endDate)
-        : BudgetID(budgetID), Amount(amount), StartDate(startDate), EndDate(endDate) {}
+        : BudgetID(budgetID), UserID(userID), CategoryID(categoryID), Amount(amount), StartDate(startDate), EndDate(endDate) {}
 
     // Implement IBudget methods
     int getBudgetID() const override { return BudgetID; }
     double getAmount() const override { return Amount; }
+
+    int getUserID() const { return UserID; }
+    int getCategoryID() const { return CategoryID; }
+    const std::chrono::system_clock::time_point& getStartDate() const { return StartDate; }
+    const std::chrono::system_clock::time_point& getEndDate() const { return EndDate; }
 };
 
 // Savings Goal Class
 class SavingsGoal : public ISavingsGoal {
 private:
     int GoalID;
+    int UserID;
     double TargetAmount;
     double CurrentAmount;
 
 public:
-    SavingsGoal(int goalID, double targetAmount, double currentAmount)
-        : GoalID(goalID), TargetAmount(targetAmount), CurrentAmount(currentAmount) {}
+    SavingsGoal(int goalID, int userID, double targetAmount, double currentAmount)
+        : GoalID(goalID), UserID(userID), TargetAmount(targetAmount), CurrentAmount(currentAmount) {}
 
     // Implement ISavingsGoal methods
     int getGoalID() const override { return GoalID; }
     double getTargetAmount() const override { return TargetAmount; }
     double getCurrentAmount() const override { return CurrentAmount; }
+
+    int getUserID() const { return UserID; }
 };
 
 // Account Class
@@ -203,6 +229,15 @@ public:
         users.erase(userID);
     }
 
+    // All users, ordered by ID
+    std::vector<const User*> getAllUsers() const {
+        std::vector<const User*> result;
+        result.reserve(users.size());
+        for (const auto& pair : users) result.push_back(pair.second.get());
+        std::sort(result.begin(), result.end(), [](const User* a, const User* b) { return a->getUserID() < b->getUserID(); });
+        return result;
+    }
+
     void displayAllUsers() const {
         for (const auto& pair : users) {
             std::cout << "User ID: " << pair.second->getUserID()
@@ -212,43 +247,401 @@ public:
     }
 };
 
+// Transaction Observer Interface
+// An update is reported as the old transaction removed and the new one added.
+class ITransactionObserver {
+public:
+    virtual ~ITransactionObserver() = default;
+    virtual void onTransactionAdded(const Transaction& transaction) = 0;
+    virtual void onTransactionRemoved(const Transaction& transaction) = 0;
+};
+
+// One row for TransactionManager::createTransactions
+struct PendingTransaction {
+    int UserID;
+    double Amount;
+    int CategoryID;
+    TransactionType Type;
+    std::chrono::system_clock::time_point Date;
+};
+
 // TransactionManager Class
+// Transactions are stored column by column in parallel arrays indexed by transaction ID (IDs are dense,
+// starting at 1), with one bit per ID marking deleted transactions. Reports walk the columns they need
+// as plain arrays instead of chasing one heap object per transaction.
 class TransactionManager {
 private:
-    std::unordered_map<int, std::unique_ptr<Transaction>> transactions;
+    std::vector<double> amounts;
+    std::vector<std::chrono::system_clock::time_point> dates;
+    std::vector<int> categoryIDs;
+    std::vector<int> userIDs;
+    std::vector<std::uint8_t> types; // TransactionType
+    std::vector<std::uint64_t> deletedBits;
     int nextTransactionID = 1;
+    std::vector<ITransactionObserver*> observers;
+
+    static size_t indexOf(int transactionID) { return static_cast<size_t>(transactionID - 1); }
+
+    bool isDeleted(size_t index) const {
+        return (deletedBits[index >> 6] >> (index & 63)) & 1;
+    }
+
+    bool exists(int transactionID) const {
+        return transactionID >= 1 && transactionID < nextTransactionID && !isDeleted(indexOf(transactionID));
+    }
+
+    // Sum of the live amounts whose row matches. A single running sum makes every addition wait for the one
+    // before it, so rows are added into four independent sums that are combined at the end.
+    template <typename Matches>
+    double sumLiveAmounts(Matches matches) const {
+        double sums[4] = {};
+        const size_t count = amounts.size();
+        size_t index = 0;
+        for (; index + 4 <= count; index += 4) {
+            sums[0] += matches(index) && !isDeleted(index) ? amounts[index] : 0.0;
+            sums[1] += matches(index + 1) && !isDeleted(index + 1) ? amounts[index + 1] : 0.0;
+            sums[2] += matches(index + 2) && !isDeleted(index + 2) ? amounts[index + 2] : 0.0;
+            sums[3] += matches(index + 3) && !isDeleted(index + 3) ? amounts[index + 3] : 0.0;
+        }
+        for (; index < count; ++index) sums[0] += matches(index) && !isDeleted(index) ? amounts[index] : 0.0;
+        return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+    }
 
 public:
-    void createTransaction(int userID, double amount, int categoryID, TransactionType type) {
-        transactions[nextTransactionID] = std::make_unique<Transaction>(nextTransactionID, userID, amount, std::chrono::system_clock::now(), categoryID, type);
-        nextTransactionID++;
+    void addObserver(ITransactionObserver* observer) {
+        observers.push_back(observer);
+    }
+
+    void reserve(size_t transactionCount) {
+        amounts.reserve(transactionCount);
+        dates.reserve(transactionCount);
+        categoryIDs.reserve(transactionCount);
+        userIDs.reserve(transactionCount);
+        types.reserve(transactionCount);
+        deletedBits.reserve((transactionCount + 63) / 64);
     }
 
-    Transaction* readTransaction(int transactionID) {
-        auto it = transactions.find(transactionID);
-        return it != transactions.end() ? it->second.get() : nullptr;
+    int createTransaction(int userID, double amount, int categoryID, TransactionType type) {
+        return createTransaction(userID, amount, categoryID, type, std::chrono::system_clock::now());
     }
 
+    int createTransaction(int userID, double amount, int categoryID, TransactionType type, const std::chrono::system_clock::time_point& date) {
+        amounts.push_back(amount);
+        dates.push_back(date);
+        categoryIDs.push_back(categoryID);
+        userIDs.push_back(userID);
+        types.push_back(static_cast<std::uint8_t>(type));
+        if (amounts.size() > deletedBits.size() * 64) {
+            deletedBits.push_back(0);
+        }
+        int transactionID = nextTransactionID++;
+        if (!observers.empty()) {
+            Transaction added = *readTransaction(transactionID);
+            for (ITransactionObserver* observer : observers) observer->onTransactionAdded(added);
+        }
+        return transactionID;
+    }
+
+    // Append a batch in one pass over each column; observers still see every transaction.
+    // Returns the ID of the first one, the rest follow in order.
+    int createTransactions(const std::vector<PendingTransaction>& batch) {
+        int firstID = nextTransactionID;
+        for (const PendingTransaction& pending : batch) amounts.push_back(pending.Amount);
+        for (const PendingTransaction& pending : batch) dates.push_back(pending.Date);
+        for (const PendingTransaction& pending : batch) categoryIDs.push_back(pending.CategoryID);
+        for (const PendingTransaction& pending : batch) userIDs.push_back(pending.UserID);
+        for (const PendingTransaction& pending : batch) types.push_back(static_cast<std::uint8_t>(pending.Type));
+        deletedBits.resize((amounts.size() + 63) / 64, 0);
+        nextTransactionID += static_cast<int>(batch.size());
+
+        if (!observers.empty()) {
+            for (int transactionID = firstID; transactionID < nextTransactionID; ++transactionID) {
+                Transaction added = *readTransaction(transactionID);
+                for (ITransactionObserver* observer : observers) observer->onTransactionAdded(added);
+            }
+        }
+        return firstID;
+    }
+
+    std::optional<Transaction> readTransaction(int transactionID) const {
+        if (!exists(transactionID)) return std::nullopt;
+        size_t index = indexOf(transactionID);
+        return Transaction(transactionID, userIDs[index], amounts[index], dates[index], categoryIDs[index],
+            static_cast<TransactionType>(types[index]));
+    }
+
+    // Keeps the transaction's user; amount, category and type are replaced and the date is set to now
     void updateTransaction(int transactionID, double amount, int categoryID, TransactionType type) {
-        Transaction* transaction = readTransaction(transactionID);
-        if (transaction) {
-            *transaction = Transaction(transactionID, transaction->getTransactionID(), amount, std::chrono::system_clock::now(), categoryID, type); // Update details
+        if (!exists(transactionID)) return;
+        if (!observers.empty()) {
+            Transaction removed = *readTransaction(transactionID);
+            for (ITransactionObserver* observer : observers) observer->onTransactionRemoved(removed);
+        }
+
+        size_t index = indexOf(transactionID);
+        amounts[index] = amount;
+        dates[index] = std::chrono::system_clock::now();
+        categoryIDs[index] = categoryID;
+        types[index] = static_cast<std::uint8_t>(type);
+
+        if (!observers.empty()) {
+            Transaction added = *readTransaction(transactionID);
+            for (ITransactionObserver* observer : observers) observer->onTransactionAdded(added);
         }
     }
 
     void deleteTransaction(int transactionID) {
-        transactions.erase(transactionID);
+        if (!exists(transactionID)) return;
+        if (!observers.empty()) {
+            Transaction removed = *readTransaction(transactionID);
+            for (ITransactionObserver* observer : observers) observer->onTransactionRemoved(removed);
+        }
+        size_t index = indexOf(transactionID);
+        deletedBits[index >> 6] |= std::uint64_t(1) << (index & 63);
+    }
+
+    // Sum of all live transactions of one type
+    double getTotal(TransactionType type) const {
+        const std::uint8_t wanted = static_cast<std::uint8_t>(type);
+        return sumLiveAmounts([&](size_t index) { return types[index] == wanted; });
+    }
+
+    // Sum of one user's live transactions of one type
+    double getTotalForUser(int userID, TransactionType type) const {
+        const std::uint8_t wanted = static_cast<std::uint8_t>(type);
+        return sumLiveAmounts([&](size_t index) { return userIDs[index] == userID && types[index] == wanted; });
     }
 
     void displayAllTransactions() const {
-        for (const auto& pair : transactions) {
-            std::cout << "Transaction ID: " << pair.second->getTransactionID()
-                << ", Amount: " << pair.second->getAmount()
-                << ", Type: " << (pair.second->getType() == TransactionType::Income ? "Income" : "Expense") << std::endl;
+        for (size_t index = 0; index < amounts.size(); ++index) {
+            if (isDeleted(index)) continue;
+            std::cout << "Transaction ID: " << index + 1
+                << ", Amount: " << amounts[index]
+                << ", Type: " << (static_cast<TransactionType>(types[index]) == TransactionType::Income ? "Income" : "Expense") << std::endl;
         }
     }
 };
 
+// Calendar helpers (UTC). Days are counted from 1970-01-01; conversions use March-based years
+// so the leap day falls at the end of the year.
+long long dayIndexOf(const std::chrono::system_clock::time_point& date) {
+    long long hours = std::chrono::duration_cast<std::chrono::hours>(date.time_since_epoch()).count();
+    return hours >= 0 ? hours / 24 : (hours - 23) / 24;
+}
+
+long long daysFromCivil(long long year, int month, int day) {
+    year -= month <= 2 ? 1 : 0;
+    long long era = (year >= 0 ? year : year - 399) / 400;
+    long long yearOfEra = year - era * 400;
+    long long dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    long long dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+void civilFromDays(long long days, long long& year, int& month, int& day) {
+    days += 719468;
+    long long era = (days >= 0 ? days : days - 146096) / 146097;
+    long long dayOfEra = days - era * 146097;
+    long long yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    long long dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    long long monthIndex = (5 * dayOfYear + 2) / 153;
+    day = static_cast<int>(dayOfYear - (153 * monthIndex + 2) / 5 + 1);
+    month = static_cast<int>(monthIndex < 10 ? monthIndex + 3 : monthIndex - 9);
+    year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+}
+
+// Rollup periods for SpendingRollupIndex::getPeriodTotal
+enum class RollupPeriod { Month, Quarter, Year };
+
+// SpendingRollupIndex Class
+// Daily income and expense totals per (user, category), each series held in a Fenwick tree so the total
+// between any two dates takes O(log days). The AllCategories series holds the user's totals over every
+// category. Month, quarter and year totals are computed on first request and cached; a transaction change
+// drops only the cached periods it falls into.
+class SpendingRollupIndex : public ITransactionObserver {
+public:
+    static const int AllCategories = -1; // not a category ID, so no real category shares its series
+
+private:
+    // Per-day amounts from originDay on, with a Fenwick tree over them
+    struct DailySeries {
+        long long originDay = 0;
+        std::vector<double> daily;
+        std::vector<double> tree; // 1-based, tree[i] covers daily(i - lowbit(i), i]
+
+        void rebuild(long long newOrigin, size_t newSize) {
+            std::vector<double> moved(newSize, 0.0);
+            for (size_t i = 0; i < daily.size(); ++i) {
+                moved[static_cast<size_t>(originDay - newOrigin) + i] = daily[i];
+            }
+            daily.swap(moved);
+            originDay = newOrigin;
+
+            tree.assign(newSize + 1, 0.0);
+            for (size_t i = 1; i <= newSize; ++i) {
+                tree[i] += daily[i - 1];
+                size_t parent = i + (i & (0 - i));
+                if (parent <= newSize) tree[parent] += tree[i];
+            }
+        }
+
+        void add(long long day, double amount) {
+            if (daily.empty()) {
+                rebuild(day, 32);
+            }
+            else if (day < originDay || day >= originDay + static_cast<long long>(daily.size())) {
+                // Grow to at least double the size so repeated growth stays amortized O(1) per day added
+                long long first = std::min(day, originDay);
+                long long last = std::max(day, originDay + static_cast<long long>(daily.size()) - 1);
+                size_t size = std::max(static_cast<size_t>(last - first + 1), daily.size() * 2);
+                rebuild(day < originDay ? last - static_cast<long long>(size) + 1 : first, size);
+            }
+
+            size_t index = static_cast<size_t>(day - originDay);
+            daily[index] += amount;
+            for (size_t i = index + 1; i < tree.size(); i += i & (0 - i)) {
+                tree[i] += amount;
+            }
+        }
+
+        // Sum of the first count days of the series
+        double prefix(size_t count) const {
+            double sum = 0.0;
+            for (size_t i = std::min(count, daily.size()); i > 0; i -= i & (0 - i)) {
+                sum += tree[i];
+            }
+            return sum;
+        }
+
+        // Sum over days [fromDay, toDay], inclusive
+        double range(long long fromDay, long long toDay) const {
+            if (daily.empty() || toDay < fromDay) return 0.0;
+            long long first = std::max(fromDay, originDay) - originDay;
+            long long last = std::min(toDay, originDay + static_cast<long long>(daily.size()) - 1) - originDay;
+            if (last < first) return 0.0;
+            return prefix(static_cast<size_t>(last + 1)) - prefix(static_cast<size_t>(first));
+        }
+    };
+
+    struct SeriesPair {
+        DailySeries Income;
+        DailySeries Expenses;
+    };
+
+    struct PeriodCacheKey {
+        int UserID;
+        int CategoryID;
+        TransactionType Type;
+        RollupPeriod Period;
+        long long PeriodIndex;
+
+        bool operator==(const PeriodCacheKey& other) const {
+            return UserID == other.UserID && CategoryID == other.CategoryID && Type == other.Type
+                && Period == other.Period && PeriodIndex == other.PeriodIndex;
+        }
+    };
+
+    struct PeriodCacheKeyHash {
+        size_t operator()(const PeriodCacheKey& key) const {
+            std::uint64_t packed = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(key.UserID)) << 32)
+                ^ (static_cast<std::uint64_t>(static_cast<std::uint32_t>(key.CategoryID)) << 12)
+                ^ (static_cast<std::uint64_t>(key.Type) << 10) ^ (static_cast<std::uint64_t>(key.Period) << 8)
+                ^ static_cast<std::uint64_t>(key.PeriodIndex) * 0x9E3779B97F4A7C15ull;
+            return std::hash<std::uint64_t>()(packed);
+        }
+    };
+
+    std::unordered_map<std::uint64_t, SeriesPair> series; // keyed by makeKey(userID, categoryID)
+    mutable std::unordered_map<PeriodCacheKey, double, PeriodCacheKeyHash> periodCache;
+
+    static std::uint64_t makeKey(int userID, int categoryID) {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(userID)) << 32) | static_cast<std::uint32_t>(categoryID);
+    }
+
+    static long long periodIndexOf(RollupPeriod period, long long day) {
+        long long year;
+        int month, dayOfMonth;
+        civilFromDays(day, year, month, dayOfMonth);
+        switch (period) {
+        case RollupPeriod::Month: return year * 12 + month - 1;
+        case RollupPeriod::Quarter: return year * 4 + (month - 1) / 3;
+        default: return year;
+        }
+    }
+
+    // First and last day of a period
+    static void periodBounds(RollupPeriod period, long long periodIndex, long long& firstDay, long long& lastDay) {
+        long long year = periodIndex;
+        int firstMonth = 1, months = 12;
+        if (period == RollupPeriod::Month) {
+            year = periodIndex >= 0 ? periodIndex / 12 : (periodIndex - 11) / 12;
+            firstMonth = static_cast<int>(periodIndex - year * 12) + 1;
+            months = 1;
+        }
+        else if (period == RollupPeriod::Quarter) {
+            year = periodIndex >= 0 ? periodIndex / 4 : (periodIndex - 3) / 4;
+            firstMonth = static_cast<int>(periodIndex - year * 4) * 3 + 1;
+            months = 3;
+        }
+        firstDay = daysFromCivil(year, firstMonth, 1);
+        int nextMonth = firstMonth + months;
+        lastDay = (nextMonth > 12 ? daysFromCivil(year + 1, nextMonth - 12, 1) : daysFromCivil(year, nextMonth, 1)) - 1;
+    }
+
+    void apply(const Transaction& transaction, double sign) {
+        long long day = dayIndexOf(transaction.getDate());
+        bool income = transaction.getType() == TransactionType::Income;
+        for (int categoryID : { transaction.getCategoryID(), AllCategories }) {
+            SeriesPair& pair = series[makeKey(transaction.getUserID(), categoryID)];
+            (income ? pair.Income : pair.Expenses).add(day, sign * transaction.getAmount());
+            for (RollupPeriod period : { RollupPeriod::Month, RollupPeriod::Quarter, RollupPeriod::Year }) {
+                periodCache.erase(PeriodCacheKey{ transaction.getUserID(), categoryID, transaction.getType(), period, periodIndexOf(period, day) });
+            }
+            if (categoryID == AllCategories) break; // a transaction filed under the sentinel is counted once
+        }
+    }
+
+    double rangeTotal(int userID, int categoryID, TransactionType type, long long fromDay, long long toDay) const {
+        auto it = series.find(makeKey(userID, categoryID));
+        if (it == series.end()) return 0.0;
+        return (type == TransactionType::Income ? it->second.Income : it->second.Expenses).range(fromDay, toDay);
+    }
+
+public:
+    void onTransactionAdded(const Transaction& transaction) override { apply(transaction, 1.0); }
+    void onTransactionRemoved(const Transaction& transaction) override { apply(transaction, -1.0); }
+
+    // Total of one type for a user and category (or AllCategories) over the days from..to, inclusive
+    double getTotal(int userID, int categoryID, TransactionType type,
+        const std::chrono::system_clock::time_point& from, const std::chrono::system_clock::time_point& to) const {
+        return rangeTotal(userID, categoryID, type, dayIndexOf(from), dayIndexOf(to));
+    }
+
+    // Expenses in the budget's user and category from its start day to its end day, inclusive
+    double getBudgetSpent(const Budget& budget) const {
+        return getTotal(budget.getUserID(), budget.getCategoryID(), TransactionType::Expense, budget.getStartDate(), budget.getEndDate());
+    }
+
+    // Share of the budget already spent (1.0 = fully used)
+    double getBudgetUtilization(const Budget& budget) const {
+        return budget.getAmount() > 0.0 ? getBudgetSpent(budget) / budget.getAmount() : 0.0;
+    }
+
+    // Total of one type for the month, quarter or year containing date
+    double getPeriodTotal(int userID, int categoryID, TransactionType type, RollupPeriod period,
+        const std::chrono::system_clock::time_point& date) const {
+        PeriodCacheKey key{ userID, categoryID, type, period, periodIndexOf(period, dayIndexOf(date)) };
+        auto cached = periodCache.find(key);
+        if (cached != periodCache.end()) return cached->second;
+
+        long long firstDay, lastDay;
+        periodBounds(period, key.PeriodIndex, firstDay, lastDay);
+        double total = rangeTotal(userID, categoryID, type, firstDay, lastDay);
+        periodCache.emplace(key, total);
+        return total;
+    }
+};
+
 // CategoryManager Class
 class CategoryManager {
 private:
@@ -261,6 +654,15 @@ public:
         nextCategoryID++;
     }
 
+    // ID of the category with this name, created if there is none yet
+    int findOrCreateCategory(const std::string& categoryName, const std::string& colorCode = "") {
+        for (const auto& pair : categories) {
+            if (pair.second->getCategoryName() == categoryName) return pair.first;
+        }
+        createCategory(categoryName, colorCode);
+        return nextCategoryID - 1;
+    }
+
     Category* readCategory(int categoryID) {
         auto it = categories.find(categoryID);
         return it != categories.end() ? it->second.get() : nullptr;
@@ -276,6 +678,14 @@ public:
     void deleteCategory(int categoryID) {
         categories.erase(categoryID);
     }
+
+    std::vector<const Category*> getAllCategories() const {
+        std::vector<const Category*> result;
+        result.reserve(categories.size());
+        for (const auto& pair : categories) result.push_back(pair.second.get());
+        return result;
+    }
+
     void displayAllCategories() {
         for (const auto& pair : categories) {
             std::cout << "Category ID: " << pair.second->getCategoryID()
@@ -292,8 +702,8 @@ private:
     int nextBudgetID = 1;
 
 public:
-    void createBudget(double amount, const std::chrono::system_clock::time_point& startDate, const std::chrono::system_clock::time_point& endDate) {
-        budgets[nextBudgetID] = std::make_unique<Budget>(nextBudgetID, amount, startDate, endDate);
+    void createBudget(int userID, int categoryID, double amount, const std::chrono::system_clock::time_point& startDate, const std::chrono::system_clock::time_point& endDate) {
+        budgets[nextBudgetID] = std::make_unique<Budget>(nextBudgetID, userID, categoryID, amount, startDate, endDate);
         nextBudgetID++;
     }
 
@@ -305,7 +715,7 @@ public:
     void updateBudget(int budgetID, double amount, const std::chrono::system_clock::time_point& startDate, const std::chrono::system_clock::time_point& endDate) {
         Budget* budget = readBudget(budgetID);
         if (budget) {
-            *budget = Budget(budgetID, amount, startDate, endDate); // Update details
+            *budget = Budget(budgetID, budget->getUserID(), budget->getCategoryID(), amount, startDate, endDate); // Update details
         }
     }
 
@@ -313,6 +723,13 @@ public:
         budgets.erase(budgetID);
     }
 
+    std::vector<const Budget*> getAllBudgets() const {
+        std::vector<const Budget*> result;
+        result.reserve(budgets.size());
+        for (const auto& pair : budgets) result.push_back(pair.second.get());
+        return result;
+    }
+
     void displayAllBudgets() {
         for (const auto& pair : budgets) {
             std::cout << "Budget ID: " << pair.second->getBudgetID()
@@ -329,8 +746,8 @@ private:
     int nextGoalID = 1;
 
 public:
-    void createSavingsGoal(double targetAmount, double currentAmount) {
-        savingsGoals[nextGoalID] = std::make_unique<SavingsGoal>(nextGoalID, targetAmount, currentAmount);
+    void createSavingsGoal(int userID, double targetAmount, double currentAmount) {
+        savingsGoals[nextGoalID] = std::make_unique<SavingsGoal>(nextGoalID, userID, targetAmount, currentAmount);
         nextGoalID++;
     }
 
@@ -342,13 +759,20 @@ public:
     void updateSavingsGoal(int goalID, double targetAmount, double currentAmount) {
         SavingsGoal* goal = readSavingsGoal(goalID);
         if (goal) {
-            *goal = SavingsGoal(goalID, targetAmount, currentAmount); // Update details
+            *goal = SavingsGoal(goalID, goal->getUserID(), targetAmount, currentAmount); // Update details
         }
     }
 
     void deleteSavingsGoal(int goalID) {
         savingsGoals.erase(goalID);
     }
+    std::vector<const SavingsGoal*> getAllSavingsGoals() const {
+        std::vector<const SavingsGoal*> result;
+        result.reserve(savingsGoals.size());
+        for (const auto& pair : savingsGoals) result.push_back(pair.second.get());
+        return result;
+    }
+
     void displayAllSavingsGoals() {
         for (const auto& pair : savingsGoals) {
             std::cout << "Savings Goal ID: " << pair.second->getGoalID()
@@ -397,8 +821,599 @@ public:
 
 };
 
+// WorkStealingPool Class
+// Fixed set of worker threads, each with its own task deque. A worker takes tasks from the back of its own
+// deque and, when that is empty, steals from the front of the others, so uneven tasks still keep every
+// thread busy. Tasks receive the index of the worker running them.
+class WorkStealingPool {
+private:
+    struct WorkerQueue {
+        std::mutex Mutex;
+        std::deque<std::function<void(unsigned)>> Tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex stateMutex;
+    std::condition_variable workAvailable;
+    std::condition_variable allDone;
+    size_t queuedTasks = 0;   // submitted but not yet taken, guarded by stateMutex
+    size_t unfinishedTasks = 0; // submitted but not yet finished, guarded by stateMutex
+    size_t nextQueue = 0;
+    bool stopping = false;
+
+    bool tryTake(unsigned workerIndex, std::function<void(unsigned)>& task) {
+        {
+            WorkerQueue& own = *queues[workerIndex];
+            std::lock_guard<std::mutex> lock(own.Mutex);
+            if (!own.Tasks.empty()) {
+                task = std::move(own.Tasks.back());
+                own.Tasks.pop_back();
+                return true;
+            }
+        }
+        for (size_t offset = 1; offset < queues.size(); ++offset) {
+            WorkerQueue& victim = *queues[(workerIndex + offset) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.Mutex);
+            if (!victim.Tasks.empty()) {
+                task = std::move(victim.Tasks.front());
+                victim.Tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run(unsigned workerIndex) {
+        std::function<void(unsigned)> task;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(stateMutex);
+                workAvailable.wait(lock, [this] { return stopping || queuedTasks > 0; });
+                if (queuedTasks == 0) return;
+                --queuedTasks;
+            }
+            // A task is reserved for this worker, so one of the queues holds it
+            while (!tryTake(workerIndex, task)) std::this_thread::yield();
+            task(workerIndex);
+
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (--unfinishedTasks == 0) allDone.notify_all();
+        }
+    }
+
+public:
+    explicit WorkStealingPool(unsigned threadCount = std::thread::hardware_concurrency()) {
+        if (threadCount == 0) threadCount = 1;
+        for (unsigned i = 0; i < threadCount; ++i) queues.push_back(std::make_unique<WorkerQueue>());
+        for (unsigned i = 0; i < threadCount; ++i) workers.emplace_back(&WorkStealingPool::run, this, i);
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            stopping = true;
+        }
+        workAvailable.notify_all();
+        for (auto& worker : workers) worker.join();
+    }
+
+    unsigned getThreadCount() const { return static_cast<unsigned>(workers.size()); }
+
+    void submit(std::function<void(unsigned)> task) {
+        size_t queueIndex;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            queueIndex = nextQueue++ % queues.size();
+        }
+        {
+            std::lock_guard<std::mutex> lock(queues[queueIndex]->Mutex);
+            queues[queueIndex]->Tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            ++queuedTasks;
+            ++unfinishedTasks;
+        }
+        workAvailable.notify_one();
+    }
+
+    // Block until every submitted task has finished
+    void wait() {
+        std::unique_lock<std::mutex> lock(stateMutex);
+        allDone.wait(lock, [this] { return unfinishedTasks == 0; });
+    }
+};
+
+// StatementReportEngine Class
+// Builds every user's statement for one month in parallel: income, expenses, budget utilization and savings
+// goal progress. Users are split into blocks of usersPerTask; each block renders into its own buffer, and the
+// buffers are joined in user order and written out in one call.
+// Only reads the managers, so nothing may modify them while a report runs.
+class StatementReportEngine {
+private:
+    const UserManager& userManager;
+    const BudgetManager& budgetManager;
+    const SavingsGoalManager& savingsGoalManager;
+    const SpendingRollupIndex& spendingRollups;
+    WorkStealingPool& pool;
+
+    static const size_t usersPerTask = 256;
+
+    static void appendAmount(std::string& out, double amount) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.2f", amount);
+        out += buffer;
+    }
+
+    static void appendPercent(std::string& out, double ratio) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), " (%.1f%%)", ratio * 100.0);
+        out += buffer;
+    }
+
+public:
+    StatementReportEngine(const UserManager& users, const BudgetManager& budgets, const SavingsGoalManager& goals,
+        const SpendingRollupIndex& rollups, WorkStealingPool& workerPool)
+        : userManager(users), budgetManager(budgets), savingsGoalManager(goals), spendingRollups(rollups), pool(workerPool) {}
+
+    // Write the statements for the calendar month containing date; returns the number of statements
+    size_t writeMonthlyStatements(const std::chrono::system_clock::time_point& date, std::ostream& out) {
+        long long year;
+        int month, day;
+        civilFromDays(dayIndexOf(date), year, month, day);
+        long long firstDay = daysFromCivil(year, month, 1);
+        long long lastDay = (month == 12 ? daysFromCivil(year + 1, 1, 1) : daysFromCivil(year, month + 1, 1)) - 1;
+        auto firstDate = std::chrono::system_clock::time_point(std::chrono::hours(24 * firstDay));
+        auto lastDate = std::chrono::system_clock::time_point(std::chrono::hours(24 * lastDay));
+        char monthLabel[16];
+        std::snprintf(monthLabel, sizeof(monthLabel), "%04lld-%02d", year, month);
+
+        // Group budgets and goals by user once, so each statement only looks at its own
+        std::vector<const User*> users = userManager.getAllUsers();
+        std::unordered_map<int, std::vector<const Budget*>> budgetsByUser;
+        for (const Budget* budget : budgetManager.getAllBudgets()) budgetsByUser[budget->getUserID()].push_back(budget);
+        std::unordered_map<int, std::vector<const SavingsGoal*>> goalsByUser;
+        for (const SavingsGoal* goal : savingsGoalManager.getAllSavingsGoals()) goalsByUser[goal->getUserID()].push_back(goal);
+
+        std::vector<std::string> buffers((users.size() + usersPerTask - 1) / usersPerTask);
+        for (size_t task = 0; task < buffers.size(); ++task) {
+            size_t first = task * usersPerTask;
+            size_t last = std::min(first + usersPerTask, users.size());
+            pool.submit([&, task, first, last](unsigned) {
+                std::string& out = buffers[task];
+                for (size_t i = first; i < last; ++i) {
+                    const User& user = *users[i];
+                    int userID = user.getUserID();
+                    out += "Statement for ";
+                    out += user.getUsername();
+                    out += " (User ID: " + std::to_string(userID) + "), ";
+                    out += monthLabel;
+                    out += "\n  Income: ";
+                    appendAmount(out, spendingRollups.getTotal(userID, SpendingRollupIndex::AllCategories, TransactionType::Income, firstDate, lastDate));
+                    out += "\n  Expenses: ";
+                    appendAmount(out, spendingRollups.getTotal(userID, SpendingRollupIndex::AllCategories, TransactionType::Expense, firstDate, lastDate));
+                    out += '\n';
+
+                    auto budgets = budgetsByUser.find(userID);
+                    if (budgets != budgetsByUser.end()) {
+                        for (const Budget* budget : budgets->second) {
+                            out += "  Budget " + std::to_string(budget->getBudgetID()) + ": ";
+                            appendAmount(out, spendingRollups.getBudgetSpent(*budget));
+                            out += " of ";
+                            appendAmount(out, budget->getAmount());
+                            appendPercent(out, spendingRollups.getBudgetUtilization(*budget));
+                            out += '\n';
+                        }
+                    }
+
+                    auto goals = goalsByUser.find(userID);
+                    if (goals != goalsByUser.end()) {
+                        for (const SavingsGoal* goal : goals->second) {
+                            out += "  Savings Goal " + std::to_string(goal->getGoalID()) + ": ";
+                            appendAmount(out, goal->getCurrentAmount());
+                            out += " of ";
+                            appendAmount(out, goal->getTargetAmount());
+                            appendPercent(out, goal->getTargetAmount() > 0.0 ? goal->getCurrentAmount() / goal->getTargetAmount() : 0.0);
+                            out += '\n';
+                        }
+                    }
+                }
+            });
+        }
+        pool.wait();
+
+        std::string report;
+        size_t totalSize = 0;
+        for (const std::string& buffer : buffers) totalSize += buffer.size();
+        report.reserve(totalSize);
+        for (const std::string& buffer : buffers) report += buffer;
+        out.write(report.data(), static_cast<std::streamsize>(report.size()));
+        out.flush();
+        return users.size();
+    }
+};
+
+// StatementImporter Class
+// Streams a bank-statement CSV export into a TransactionManager. Each row is "date,userID,merchant,amount"
+// with the date as YYYY-MM-DD; a negative amount is an expense, anything else is income. The merchant may be
+// quoted to hold commas. An optional header line is skipped. The file is read in large chunks, split on
+// newlines and commas with memchr, and rows go to the store in batches. Merchants are matched
+// case-insensitively against a table built once from the category names plus any addMerchantRule entries;
+// unmatched merchants get the fallback category, which must be one of the CategoryManager's categories.
+class StatementImporter {
+public:
+    struct ImportResult {
+        bool Opened = false;
+        size_t RowsImported = 0;
+        size_t RowsRejected = 0;
+        size_t BytesRead = 0;
+        double Seconds = 0.0;
+
+        double megabytesPerSecond() const {
+            return Seconds > 0.0 ? BytesRead / (1024.0 * 1024.0) / Seconds : 0.0;
+        }
+    };
+
+private:
+    TransactionManager& transactionManager;
+    std::unordered_map<std::string, int> merchantCategories; // lower-case merchant -> category ID
+    int fallbackCategoryID;
+    std::string merchantKey; // reused for every lookup so rows do not allocate
+    std::vector<PendingTransaction> batch;
+
+    static const size_t chunkSize = 1 << 20;
+    static const size_t batchSize = 1 << 16;
+
+    static void appendLower(std::string& out, const char* begin, const char* end) {
+        for (const char* p = begin; p != end; ++p) {
+            out += (*p >= 'A' && *p <= 'Z') ? static_cast<char>(*p - 'A' + 'a') : *p;
+        }
+    }
+
+    static bool parseDigits(const char* begin, const char* end, long long& value) {
+        if (begin == end || end - begin > 18) return false;
+        value = 0;
+        for (const char* p = begin; p != end; ++p) {
+            if (*p < '0' || *p > '9') return false;
+            value = value * 10 + (*p - '0');
+        }
+        return true;
+    }
+
+    static bool parseDate(const char* begin, const char* end, std::chrono::system_clock::time_point& date) {
+        long long year, month, day;
+        if (end - begin != 10 || begin[4] != '-' || begin[7] != '-') return false;
+        if (!parseDigits(begin, begin + 4, year) || !parseDigits(begin + 5, begin + 7, month) || !parseDigits(begin + 8, end, day)) return false;
+        if (month < 1 || month > 12 || day < 1) return false;
+        long long days = daysFromCivil(year, static_cast<int>(month), static_cast<int>(day));
+        long long nextMonth = month == 12 ? daysFromCivil(year + 1, 1, 1) : daysFromCivil(year, static_cast<int>(month) + 1, 1);
+        if (days >= nextMonth) return false;
+        date = std::chrono::system_clock::time_point(std::chrono::hours(24 * days));
+        return true;
+    }
+
+    // Decimal amount with an optional sign and up to 9 fraction digits
+    static bool parseAmount(const char* begin, const char* end, double& amount) {
+        bool negative = begin != end && *begin == '-';
+        if (begin != end && (*begin == '-' || *begin == '+')) ++begin;
+        const char* point = static_cast<const char*>(std::memchr(begin, '.', end - begin));
+        const char* wholeEnd = point ? point : end;
+        long long whole = 0, fraction = 0;
+        if (wholeEnd != begin && !parseDigits(begin, wholeEnd, whole)) return false;
+        if (point) {
+            const char* fractionBegin = point + 1;
+            if (end - fractionBegin > 9 || (fractionBegin != end && !parseDigits(fractionBegin, end, fraction))) return false;
+            if (wholeEnd == begin && fractionBegin == end) return false;
+            double scale = 1.0;
+            for (const char* p = fractionBegin; p != end; ++p) scale *= 10.0;
+            amount = whole + fraction / scale;
+        }
+        else {
+            if (wholeEnd == begin) return false;
+            amount = static_cast<double>(whole);
+        }
+        if (negative) amount = -amount;
+        return true;
+    }
+
+    // Fills merchantKey with the lower-cased merchant and returns the position after it
+    const char* readMerchant(const char* begin, const char* end) {
+        merchantKey.clear();
+        if (begin == end || *begin != '"') {
+            const char* comma = static_cast<const char*>(std::memchr(begin, ',', end - begin));
+            if (!comma) return nullptr;
+            appendLower(merchantKey, begin, comma);
+            return comma;
+        }
+        // Quoted: "" inside stands for one quote
+        const char* p = begin + 1;
+        while (true) {
+            const char* quote = static_cast<const char*>(std::memchr(p, '"', end - p));
+            if (!quote) return nullptr;
+            appendLower(merchantKey, p, quote);
+            if (quote + 1 != end && quote[1] == '"') {
+                merchantKey += '"';
+                p = quote + 2;
+                continue;
+            }
+            return quote + 1 != end && quote[1] == ',' ? quote + 1 : nullptr;
+        }
+    }
+
+    bool parseRow(const char* begin, const char* end, PendingTransaction& row) {
+        const char* dateEnd = static_cast<const char*>(std::memchr(begin, ',', end - begin));
+        if (!dateEnd || !parseDate(begin, dateEnd, row.Date)) return false;
+        const char* userBegin = dateEnd + 1;
+        const char* userEnd = static_cast<const char*>(std::memchr(userBegin, ',', end - userBegin));
+        long long userID;
+        if (!userEnd || !parseDigits(userBegin, userEnd, userID) || userID > 0x7fffffff) return false;
+        const char* merchantEnd = readMerchant(userEnd + 1, end);
+        if (!merchantEnd) return false;
+        double amount;
+        if (!parseAmount(merchantEnd + 1, end, amount)) return false;
+
+        auto category = merchantCategories.find(merchantKey);
+        row.UserID = static_cast<int>(userID);
+        row.CategoryID = category != merchantCategories.end() ? category->second : fallbackCategoryID;
+        row.Type = amount < 0.0 ? TransactionType::Expense : TransactionType::Income;
+        row.Amount = amount < 0.0 ? -amount : amount;
+        return true;
+    }
+
+    void processLine(const char* begin, const char* end, bool& firstLine, ImportResult& result) {
+        if (end != begin && end[-1] == '\r') --end;
+        bool header = firstLine;
+        firstLine = false;
+        if (begin == end) return;
+        PendingTransaction row;
+        if (!parseRow(begin, end, row)) {
+            if (!header) ++result.RowsRejected;
+            return;
+        }
+        batch.push_back(row);
+        if (batch.size() == batchSize) flush(result);
+    }
+
+    void flush(ImportResult& result) {
+        if (batch.empty()) return;
+        transactionManager.createTransactions(batch);
+        result.RowsImported += batch.size();
+        batch.clear();
+    }
+
+public:
+    StatementImporter(TransactionManager& transactions, const CategoryManager& categories, int fallbackCategory)
+        : transactionManager(transactions), fallbackCategoryID(fallbackCategory) {
+        bool fallbackFound = false;
+        for (const Category* category : categories.getAllCategories()) {
+            addMerchantRule(category->getCategoryName(), category->getCategoryID());
+            fallbackFound |= category->getCategoryID() == fallbackCategory;
+        }
+        if (!fallbackFound) throw std::invalid_argument("Fallback category " + std::to_string(fallbackCategory) + " does not exist");
+        batch.reserve(batchSize);
+    }
+
+    // Send rows from this merchant (any case) to the given category
+    void addMerchantRule(const std::string& merchant, int categoryID) {
+        std::string key;
+        appendLower(key, merchant.data(), merchant.data() + merchant.size());
+        merchantCategories[key] = categoryID;
+    }
+
+    ImportResult importFile(const std::string& path) {
+        ImportResult result;
+        auto started = std::chrono::steady_clock::now();
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file) return result;
+        result.Opened = true;
+
+        std::vector<char> buffer(chunkSize);
+        size_t carried = 0; // bytes of an unfinished line kept at the front of the buffer
+        bool firstLine = true;
+        while (true) {
+            if (carried == buffer.size()) buffer.resize(buffer.size() * 2); // line longer than the buffer
+            size_t got = std::fread(buffer.data() + carried, 1, buffer.size() - carried, file);
+            result.BytesRead += got;
+            const char* cursor = buffer.data();
+            const char* limit = buffer.data() + carried + got;
+            while (const char* newline = static_cast<const char*>(std::memchr(cursor, '\n', limit - cursor))) {
+                processLine(cursor, newline, firstLine, result);
+                cursor = newline + 1;
+            }
+            carried = static_cast<size_t>(limit - cursor);
+            if (got == 0) {
+                processLine(cursor, limit, firstLine, result); // last line without a newline
+                break;
+            }
+            std::memmove(buffer.data(), cursor, carried);
+        }
+        std::fclose(file);
+        flush(result);
+
+        result.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        return result;
+    }
+};
+
+// Time getTotal and getTotalForUser over rowCount transactions (100 users, a quarter of them income, one in
+// a hundred deleted), run with --benchmark [rows], 50M by default. Needs about 25 bytes per row.
+void runTotalsBenchmark(size_t rowCount) {
+    const size_t batchSize = 1000000;
+    TransactionManager transactionManager;
+    transactionManager.reserve(rowCount);
+    std::uint32_t seed = 2024;
+    auto nextRandom = [&seed] { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+    const auto date = std::chrono::system_clock::now();
+    std::vector<PendingTransaction> batch;
+    batch.reserve(batchSize);
+    for (size_t added = 0; added < rowCount; added += batch.size()) {
+        batch.clear();
+        for (size_t i = 0; i < std::min(batchSize, rowCount - added); ++i) {
+            batch.push_back(PendingTransaction{ static_cast<int>(nextRandom() % 100) + 1, (nextRandom() % 100000) / 100.0,
+                static_cast<int>(nextRandom() % 20) + 1, nextRandom() % 4 == 0 ? TransactionType::Income : TransactionType::Expense, date });
+        }
+        transactionManager.createTransactions(batch);
+    }
+    for (size_t transactionID = 1; transactionID <= rowCount; transactionID += 100) {
+        transactionManager.deleteTransaction(static_cast<int>(transactionID));
+    }
+
+    // Best of five runs, so one slow run does not hide the cost of the scan itself
+    auto timeTotal = [](const char* label, const std::function<double()>& total) {
+        double value = 0.0;
+        double best = 0.0;
+        for (int run = 0; run < 5; ++run) {
+            auto start = std::chrono::steady_clock::now();
+            value = total();
+            double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            best = run == 0 ? milliseconds : std::min(best, milliseconds);
+        }
+        std::cout << "  " << label << ": " << best << " ms (total " << static_cast<long long>(value) << ")" << std::endl;
+    };
+    std::cout << "Totals over " << rowCount << " transactions, best of 5:" << std::endl;
+    timeTotal("getTotal(Income)", [&] { return transactionManager.getTotal(TransactionType::Income); });
+    timeTotal("getTotal(Expense)", [&] { return transactionManager.getTotal(TransactionType::Expense); });
+    timeTotal("getTotalForUser(7, Expense)", [&] { return transactionManager.getTotalForUser(7, TransactionType::Expense); });
+}
+
+#ifdef _DEBUG
+// Debug builds run these checks with --self-test
+bool checkSelfTest(bool condition, const std::string& description) {
+    std::cout << (condition ? "[PASS] " : "[FAIL] ") << description << std::endl;
+    return condition;
+}
+
+std::chrono::system_clock::time_point dateOf(long long year, int month, int day) {
+    return std::chrono::system_clock::time_point(std::chrono::hours(24 * daysFromCivil(year, month, day)));
+}
+
+bool testBudgetSpentCoversExactDays() {
+    // A budget from mid-January to mid-February counts only the expenses on the days it covers
+    TransactionManager transactionManager;
+    SpendingRollupIndex spendingRollups;
+    transactionManager.addObserver(&spendingRollups);
+    transactionManager.createTransactions({
+        { 1, 10.0, 1, TransactionType::Expense, dateOf(2024, 1, 10) },
+        { 1, 20.0, 1, TransactionType::Expense, dateOf(2024, 1, 15) },
+        { 1, 40.0, 1, TransactionType::Expense, dateOf(2024, 2, 10) },
+        { 1, 80.0, 1, TransactionType::Expense, dateOf(2024, 2, 25) },
+        { 1, 160.0, 2, TransactionType::Expense, dateOf(2024, 1, 20) },
+        { 1, 320.0, 1, TransactionType::Income, dateOf(2024, 1, 20) } });
+
+    Budget budget(1, 1, 1, 120.0, dateOf(2024, 1, 15), dateOf(2024, 2, 10));
+    return checkSelfTest(spendingRollups.getBudgetSpent(budget) == 60.0 && spendingRollups.getBudgetUtilization(budget) == 0.5,
+        "budget spent covers only the budget's days");
+}
+
+bool testAllCategoriesCountsEachTransactionOnce() {
+    // Uncategorized (0) and sentinel-valued transactions must not land in the all-categories totals twice
+    TransactionManager transactionManager;
+    SpendingRollupIndex spendingRollups;
+    transactionManager.addObserver(&spendingRollups);
+    transactionManager.createTransactions({
+        { 1, 5.0, 0, TransactionType::Expense, dateOf(2024, 3, 1) },
+        { 1, 7.0, 1, TransactionType::Expense, dateOf(2024, 3, 2) },
+        { 1, 11.0, SpendingRollupIndex::AllCategories, TransactionType::Expense, dateOf(2024, 3, 3) } });
+
+    double total = spendingRollups.getPeriodTotal(1, SpendingRollupIndex::AllCategories, TransactionType::Expense, RollupPeriod::Month, dateOf(2024, 3, 15));
+    double uncategorized = spendingRollups.getTotal(1, 0, TransactionType::Expense, dateOf(2024, 3, 1), dateOf(2024, 3, 31));
+    return checkSelfTest(total == 23.0 && uncategorized == 5.0, "all-categories totals count each transaction once");
+}
+
+bool testStatementsFollowUserOrder() {
+    // Enough users for many tasks spread over several workers; statements must still come out by user ID
+    UserManager userManager;
+    BudgetManager budgetManager;
+    SavingsGoalManager savingsGoalManager;
+    SpendingRollupIndex spendingRollups;
+    const int userCount = 3000;
+    for (int i = 1; i <= userCount; ++i) userManager.createUser("User" + std::to_string(i), "hash", "user@example.com");
+
+    WorkStealingPool pool(4);
+    StatementReportEngine reportEngine(userManager, budgetManager, savingsGoalManager, spendingRollups, pool);
+    std::ostringstream report;
+    size_t written = reportEngine.writeMonthlyStatements(dateOf(2024, 5, 1), report);
+
+    std::istringstream lines(report.str());
+    std::string line;
+    int expectedID = 1;
+    bool ordered = true;
+    while (std::getline(lines, line)) {
+        if (line.compare(0, 14, "Statement for ") != 0) continue;
+        ordered &= line.find("(User ID: " + std::to_string(expectedID) + ")") != std::string::npos;
+        ++expectedID;
+    }
+    return checkSelfTest(written == userCount && ordered && expectedID == userCount + 1, "statements are written in user order");
+}
+
+bool testImportFilesUnmatchedMerchantsUnderFallback() {
+    UserManager userManager;
+    TransactionManager transactionManager;
+    CategoryManager categoryManager;
+    BudgetManager budgetManager;
+    SavingsGoalManager savingsGoalManager;
+    SpendingRollupIndex spendingRollups;
+    transactionManager.addObserver(&spendingRollups);
+    userManager.createUser("JohnDoe", "hash", "john@example.com");
+    categoryManager.createCategory("Food", "#FF5733");
+    int foodID = categoryManager.findOrCreateCategory("Food");
+    int uncategorizedID = categoryManager.findOrCreateCategory("Uncategorized");
+
+    bool rejectedMissingFallback = false;
+    try {
+        StatementImporter importer(transactionManager, categoryManager, 0);
+    }
+    catch (const std::invalid_argument&) {
+        rejectedMissingFallback = true;
+    }
+
+    const char* path = "SelfTestStatement.csv";
+    std::FILE* file = std::fopen(path, "wb");
+    if (!file) return checkSelfTest(false, "unmatched merchants are imported under the fallback category");
+    std::fputs("date,userID,merchant,amount\n2024-06-03,1,Food,-5.00\n2024-06-04,1,Starbucks,-10.00\n2024-06-05,1,Employer,100.00\n", file);
+    std::fclose(file);
+    StatementImporter importer(transactionManager, categoryManager, uncategorizedID);
+    StatementImporter::ImportResult imported = importer.importFile(path);
+    std::remove(path);
+
+    WorkStealingPool pool(2);
+    StatementReportEngine reportEngine(userManager, budgetManager, savingsGoalManager, spendingRollups, pool);
+    std::ostringstream report;
+    reportEngine.writeMonthlyStatements(dateOf(2024, 6, 1), report);
+
+    auto june = [&](int categoryID, TransactionType type) {
+        return spendingRollups.getTotal(1, categoryID, type, dateOf(2024, 6, 1), dateOf(2024, 6, 30));
+    };
+    bool totals = report.str().find("Income: 100.00\n  Expenses: 15.00\n") != std::string::npos;
+    bool categories = june(foodID, TransactionType::Expense) == 5.0 && june(uncategorizedID, TransactionType::Expense) == 10.0
+        && june(uncategorizedID, TransactionType::Income) == 100.0;
+    return checkSelfTest(rejectedMissingFallback && imported.RowsImported == 3 && imported.RowsRejected == 0 && totals && categories,
+        "unmatched merchants are imported under the fallback category");
+}
+
+int runSelfTests() {
+    bool passed = true;
+    passed &= testBudgetSpentCoversExactDays();
+    passed &= testAllCategoriesCountsEachTransactionOnce();
+    passed &= testStatementsFollowUserOrder();
+    passed &= testImportFilesUnmatchedMerchantsUnderFallback();
+
+    std::cout << (passed ? "\nAll self tests passed.\n" : "\nSome self tests failed.\n");
+    return passed ? 0 : 1;
+}
+#endif
+
 // Main function
-int main() {
+int main(int argc, char* argv[]) {
+#ifdef _DEBUG
+    if (argc > 1 && std::string(argv[1]) == "--self-test") return runSelfTests();
+#endif
+    if (argc > 1 && std::string(argv[1]) == "--benchmark") {
+        runTotalsBenchmark(argc > 2 ? std::stoull(argv[2]) : 50000000);
+        return 0;
+    }
+
     //UserManager userManager;
     //TransactionManager transactionManager;
     //CategoryManager categoryManager;
@@ -431,6 +1446,8 @@ int main() {
     BudgetManager budgetManager;
     SavingsGoalManager savingsGoalManager;
     AccountManager accountManager;
+    SpendingRollupIndex spendingRollups;
+    transactionManager.addObserver(&spendingRollups);
 
     // Sample data
     userManager.createUser("JohnDoe", "password123", "john@example.com");
@@ -439,8 +1456,8 @@ int main() {
     transactionManager.createTransaction(2, 50.0, 1, TransactionType::Expense);
     categoryManager.createCategory("Food", "#FF5733");
     categoryManager.createCategory("Transport", "#33FF57");
-    budgetManager.createBudget(1000.0, std::chrono::system_clock::now(), std::chrono::system_clock::now());
-    savingsGoalManager.createSavingsGoal(5000.0, 2000.0);
+    budgetManager.createBudget(2, 1, 1000.0, std::chrono::system_clock::now(), std::chrono::system_clock::now());
+    savingsGoalManager.createSavingsGoal(1, 5000.0, 2000.0);
     accountManager.createAccount("Checking", 1500.0, AccountType::Bank);
     accountManager.createAccount("Cash", 200.0, AccountType::Cash);
 
@@ -449,15 +1466,43 @@ int main() {
     userManager.displayAllUsers();
     std::cout << "\nAll Transactions:\n";
     transactionManager.displayAllTransactions();
+    std::cout << "Total Income: " << transactionManager.getTotal(TransactionType::Income)
+        << ", Total Expenses: " << transactionManager.getTotal(TransactionType::Expense) << std::endl;
     std::cout << "\nAll Categories:\n";
     categoryManager.displayAllCategories();
     std::cout << "\nAll Budgets:\n";
     budgetManager.displayAllBudgets();
+    if (Budget* budget = budgetManager.readBudget(1)) {
+        std::cout << "Budget 1 utilization: " << spendingRollups.getBudgetUtilization(*budget) * 100 << "%" << std::endl;
+    }
+    std::cout << "JaneDoe expenses this year: "
+        << spendingRollups.getPeriodTotal(2, SpendingRollupIndex::AllCategories, TransactionType::Expense, RollupPeriod::Year, std::chrono::system_clock::now())
+        << std::endl;
     std::cout << "\nAll Savings Goals:\n";
     savingsGoalManager.displayAllSavingsGoals();
     std::cout << "\nAll Accounts:\n";
     accountManager.displayAllAccounts();
 
+    // Bulk import: run with --import <statement.csv>
+    if (argc > 2 && std::string(argv[1]) == "--import") {
+        StatementImporter importer(transactionManager, categoryManager, categoryManager.findOrCreateCategory("Uncategorized"));
+        StatementImporter::ImportResult imported = importer.importFile(argv[2]);
+        if (!imported.Opened) {
+            std::cout << "\nCould not open " << argv[2] << std::endl;
+        }
+        else {
+            std::cout << "\nImported " << imported.RowsImported << " transactions (" << imported.RowsRejected << " rejected), "
+                << imported.BytesRead / (1024.0 * 1024.0) << " MB in " << imported.Seconds << " s, "
+                << imported.megabytesPerSecond() << " MB/s" << std::endl;
+        }
+    }
+
+    // Monthly statements for every user, built in parallel
+    WorkStealingPool pool;
+    StatementReportEngine reportEngine(userManager, budgetManager, savingsGoalManager, spendingRollups, pool);
+    std::cout << "\nMonthly Statements:\n";
+    reportEngine.writeMonthlyStatements(std::chrono::system_clock::now(), std::cout);
+
 
 
 
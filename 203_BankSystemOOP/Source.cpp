@@ -135,26 +135,57 @@
 //--------------------------------------------enhanced 
 
 #include <iostream>
+#include <fstream>
 #include <string>
 #include <stdexcept>
 #include <vector>
 #include <unordered_map>
+#include <algorithm>
+#include <memory>
+#include <cstdint>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <future>
+#include <chrono>
+#include <filesystem>
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "../Common/Money.h"
+
+// Concrete account classes, stored in the journal and snapshots so recovery re-creates the right class
+enum class AccountKind : std::uint8_t { Savings };
 
 // Base class representing an Account
 class Account {
 protected:
     std::string accountNumber;
-    double balance;
+    Money balance;
 
 public:
-    Account(const std::string& accountNumber, double initialBalance)
+    Account(const std::string& accountNumber, Money initialBalance)
         : accountNumber(accountNumber), balance(initialBalance) {}
 
-    virtual void deposit(double amount) = 0;
-    virtual void withdraw(double amount) = 0;
-    virtual void transfer(Account& toAccount, double amount) = 0;
+    virtual void deposit(Money amount) = 0;
+    virtual void withdraw(Money amount) = 0;
+    virtual void transfer(Account& toAccount, Money amount) = 0;
+    virtual AccountKind getKind() const = 0;
 
-    double getBalance() const {
+    Money getBalance() const {
         return balance;
     }
 
@@ -162,20 +193,29 @@ public:
         return accountNumber;
     }
 
+    // Used by recovery to put back a balance read from a snapshot
+    void restoreBalance(Money restored) {
+        balance = restored;
+    }
+
     virtual ~Account() {}
 };
 
 // SavingsAccount class inheriting from Account
 class SavingsAccount : public Account {
 public:
-    SavingsAccount(const std::string& accountNumber, double initialBalance)
+    SavingsAccount(const std::string& accountNumber, Money initialBalance)
         : Account(accountNumber, initialBalance) {}
 
-    void deposit(double amount) override {
+    AccountKind getKind() const override {
+        return AccountKind::Savings;
+    }
+
+    void deposit(Money amount) override {
         balance += amount;
     }
 
-    void withdraw(double amount) override {
+    void withdraw(Money amount) override {
         if (balance >= amount) {
             balance -= amount;
         }
@@ -184,7 +224,7 @@ public:
         }
     }
 
-    void transfer(Account& toAccount, double amount) override {
+    void transfer(Account& toAccount, Money amount) override {
         if (balance >= amount) {
             this->withdraw(amount);
             toAccount.deposit(amount);
@@ -195,119 +235,1886 @@ public:
     }
 };
 
-// Transaction class representing a bank transaction
-class Transaction {
-protected:
-    std::string transactionId;
-    std::string accountNumber;
-    std::string type; // Deposit, Withdrawal, Transfer
-    double amount;
-    std::string description;
-    std::string status;
-    std::string date;
-    double balanceAfterTransaction;
+// Transaction kinds and outcomes, stored as one byte each in the ledger.
+// A transfer is recorded twice: a Transfer record on the sender with the sender's balance, and a TransferIn
+// record on the beneficiary with the beneficiary's balance. The journal holds only the Transfer; replay adds both.
+// Refund is the compensating credit ShardedBankSystem records when the credit side of a transfer cannot be applied.
+enum class TransactionType : std::uint8_t { Deposit, Withdrawal, Transfer, TransferIn, Refund };
+enum class TransactionStatus : std::uint8_t { Completed, Failed };
+
+// Transaction dates are stored as days since 1970-01-01 so they compare and binary-search as integers.
+// Runs once per transaction, so the digits are read by hand rather than through a stream
+std::int32_t parseDate(const std::string& date) {
+    auto readDigits = [&date](std::size_t first, std::size_t count, int& value) {
+        value = 0;
+        for (std::size_t i = first; i < first + count; ++i) {
+            if (date[i] < '0' || date[i] > '9') return false;
+            value = value * 10 + (date[i] - '0');
+        }
+        return true;
+    };
+
+    static const int daysInMonth[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    int year = 0, month = 0, day = 0;
+    bool valid = date.size() == 10 && date[4] == '-' && date[7] == '-'
+        && readDigits(0, 4, year) && readDigits(5, 2, month) && readDigits(8, 2, day) && month >= 1 && month <= 12;
+    bool leapYear = year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+    if (!valid || day < 1 || day > daysInMonth[month - 1] + (month == 2 && leapYear ? 1 : 0)) {
+        throw std::invalid_argument("Invalid date, expected YYYY-MM-DD: " + date);
+    }
+
+    // Civil calendar to day count, using March-based years so the leap day falls at the end
+    year -= month <= 2 ? 1 : 0;
+    int era = (year >= 0 ? year : year - 399) / 400;
+    int yearOfEra = year - era * 400;
+    int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+std::string formatDate(std::int32_t days) {
+    days += 719468;
+    int era = (days >= 0 ? days : days - 146096) / 146097;
+    int dayOfEra = days - era * 146097;
+    int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int monthIndex = (5 * dayOfYear + 2) / 153;
+    int day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    int month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    int year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d", year, month, day);
+    return buffer;
+}
+
+// Keeps one copy of each repeated string (account numbers, descriptions) and hands out small ids
+class StringPool {
+private:
+    std::vector<std::string> strings;
+    std::unordered_map<std::string, std::uint32_t> ids;
 
 public:
-    Transaction(const std::string& transactionId, const std::string& accountNumber, const std::string& type, double amount,
-        const std::string& description, const std::string& status, const std::string& date, double balanceAfterTransaction)
-        : transactionId(transactionId), accountNumber(accountNumber), type(type), amount(amount),
-        description(description), status(status), date(date), balanceAfterTransaction(balanceAfterTransaction) {}
+    std::uint32_t intern(const std::string& text) {
+        auto found = ids.find(text);
+        if (found != ids.end()) {
+            return found->second;
+        }
+        std::uint32_t id = static_cast<std::uint32_t>(strings.size());
+        strings.push_back(text);
+        ids.emplace(text, id);
+        return id;
+    }
+
+    // Look up a string without adding it
+    bool find(const std::string& text, std::uint32_t& id) const {
+        auto found = ids.find(text);
+        if (found == ids.end()) {
+            return false;
+        }
+        id = found->second;
+        return true;
+    }
 
-    std::string getDetails() const {
-        return "Transaction ID: " + transactionId + ", Type: " + type + ", Amount: " + std::to_string(amount) +
-            ", Status: " + status + ", Date: " + date + ", Balance After: " + std::to_string(balanceAfterTransaction);
+    const std::string& get(std::uint32_t id) const {
+        return strings[id];
     }
 };
 
-// Derived classes for different types of transactions
-class Deposit : public Transaction {
+// Compact, trivially copyable record of one bank transaction.
+// The description ("Cash Deposit", "Transfer to ...") is derived from the type when rendered.
+struct TransactionRecord {
+    std::uint64_t transactionNumber; // shown as "TXN<number>"
+    Money amount;
+    Money balanceAfterTransaction;
+    std::uint32_t accountId;       // interned account number
+    std::uint32_t beneficiaryId;   // interned beneficiary account number, transfers only
+    std::int32_t date;             // days since 1970-01-01, see parseDate
+    TransactionType type;
+    TransactionStatus status;
+};
+
+// 38 bytes of fields padded to the 8-byte alignment of transactionNumber
+static_assert(sizeof(TransactionRecord) == 40, "TransactionRecord layout changed");
+
+// Ledger offsets touching one account, kept sorted by date.
+// dates[i] is the date of ledger record offsets[i]; the two arrays are searched together.
+struct AccountHistory {
+    std::vector<std::int32_t> dates;
+    std::vector<std::size_t> offsets;
+
+    void add(std::int32_t date, std::size_t offset) {
+        if (dates.empty() || date >= dates.back()) {
+            dates.push_back(date);
+            offsets.push_back(offset);
+            return;
+        }
+        // Back-dated entry: insert after every record of the same or an earlier date
+        std::size_t position = std::upper_bound(dates.begin(), dates.end(), date) - dates.begin();
+        dates.insert(dates.begin() + position, date);
+        offsets.insert(offsets.begin() + position, offset);
+    }
+};
+
+// Append-only transaction ledger.
+// Records live in fixed-size chunks that are never moved or freed before the ledger itself,
+// so appending is O(1) and each chunk can be scanned as a plain array.
+// Every record is also indexed under its own account for statement queries; the beneficiary of a transfer sees
+// the transfer through its own TransferIn record.
+class Ledger {
+private:
+    static constexpr std::size_t chunkSize = 4096;
+
+    std::vector<std::unique_ptr<TransactionRecord[]>> chunks;
+    std::size_t recordCount = 0;
+    std::uint64_t firstTransactionNumber = 1;
+    StringPool strings;
+    std::unordered_map<std::uint32_t, AccountHistory> histories; // keyed by interned account number
+
+    // The chunk is owned before it is added, so a failed push_back cannot leak it
+    void addChunk() {
+        std::unique_ptr<TransactionRecord[]> chunk(new TransactionRecord[chunkSize]);
+        chunks.push_back(std::move(chunk));
+    }
+
 public:
-    Deposit(const std::string& transactionId, const std::string& accountNumber, double amount, const std::string& date, double balanceAfter)
-        : Transaction(transactionId, accountNumber, "Deposit", amount, "Cash Deposit", "Completed", date, balanceAfter) {}
+    const TransactionRecord& append(TransactionType type, const std::string& accountNumber, const std::string& beneficiaryAccount,
+        Money amount, std::int32_t date, Money balanceAfterTransaction) {
+        if (recordCount == chunks.size() * chunkSize) {
+            addChunk();
+        }
+
+        TransactionRecord& record = chunks[recordCount / chunkSize][recordCount % chunkSize];
+        record.transactionNumber = firstTransactionNumber + recordCount;
+        record.amount = amount;
+        record.balanceAfterTransaction = balanceAfterTransaction;
+        record.accountId = strings.intern(accountNumber);
+        record.beneficiaryId = strings.intern(beneficiaryAccount);
+        record.date = date;
+        record.type = type;
+        record.status = TransactionStatus::Completed;
+
+        histories[record.accountId].add(date, recordCount);
+        ++recordCount;
+        return record;
+    }
+
+    // Visit the records of one account dated within [fromDate, toDate], oldest first.
+    // Binary search finds the start, so the cost is O(log n + k) for k matching records.
+    template <typename Visitor>
+    void forEachInRange(const std::string& accountNumber, std::int32_t fromDate, std::int32_t toDate, Visitor visit) const {
+        std::uint32_t accountId;
+        if (!strings.find(accountNumber, accountId)) {
+            return;
+        }
+        auto found = histories.find(accountId);
+        if (found == histories.end()) {
+            return;
+        }
+
+        const AccountHistory& history = found->second;
+        std::size_t first = std::lower_bound(history.dates.begin(), history.dates.end(), fromDate) - history.dates.begin();
+        for (std::size_t i = first; i < history.dates.size() && history.dates[i] <= toDate; ++i) {
+            visit((*this)[history.offsets[i]]);
+        }
+    }
+
+    // Allocate chunks up front for the given number of additional records
+    void reserve(std::size_t additionalRecords) {
+        std::size_t neededChunks = (recordCount + additionalRecords + chunkSize - 1) / chunkSize;
+        while (chunks.size() < neededChunks) {
+            addChunk();
+        }
+    }
+
+    std::size_t size() const {
+        return recordCount;
+    }
+
+    // Bytes held by the record chunks and the per-account index, not counting the string pool
+    std::size_t memoryUsage() const {
+        std::size_t bytes = chunks.size() * chunkSize * sizeof(TransactionRecord);
+        for (const auto& history : histories) {
+            bytes += history.second.dates.capacity() * sizeof(std::int32_t) + history.second.offsets.capacity() * sizeof(std::size_t);
+        }
+        return bytes;
+    }
+
+    // After recovery from a snapshot the ledger holds only the replayed tail; numbering continues from the snapshot
+    void startNumberingAt(std::uint64_t transactionNumber) {
+        if (recordCount != 0) throw std::logic_error("Ledger numbering can only change while it is empty");
+        firstTransactionNumber = transactionNumber;
+    }
+
+    std::uint64_t nextTransactionNumber() const {
+        return firstTransactionNumber + recordCount;
+    }
+
+    const TransactionRecord& operator[](std::size_t index) const {
+        return chunks[index / chunkSize][index % chunkSize];
+    }
+
+    // Records are append-only; the status is the one field that may change afterwards
+    void markFailed(std::size_t index) {
+        chunks[index / chunkSize][index % chunkSize].status = TransactionStatus::Failed;
+    }
+
+    // Visit every record in order, one contiguous chunk at a time
+    template <typename Visitor>
+    void forEach(Visitor visit) const {
+        std::size_t remaining = recordCount;
+        for (const auto& chunk : chunks) {
+            std::size_t inChunk = remaining < chunkSize ? remaining : chunkSize;
+            for (std::size_t i = 0; i < inChunk; ++i) {
+                visit(chunk[i]);
+            }
+            remaining -= inChunk;
+            if (remaining == 0) break;
+        }
+    }
+
+    const StringPool& getStrings() const {
+        return strings;
+    }
+
+    std::string getDescription(const TransactionRecord& record) const {
+        switch (record.type) {
+        case TransactionType::Deposit: return "Cash Deposit";
+        case TransactionType::Withdrawal: return "ATM Withdrawal";
+        case TransactionType::TransferIn: return "Transfer from " + strings.get(record.beneficiaryId);
+        case TransactionType::Refund: return "Refund of transfer to " + strings.get(record.beneficiaryId);
+        default: return "Transfer to " + strings.get(record.beneficiaryId);
+        }
+    }
+
+    // Append the one-line text form of a record to out
+    void appendDetails(std::string& out, const TransactionRecord& record) const {
+        static const char* typeNames[] = { "Deposit", "Withdrawal", "Transfer", "Transfer In", "Refund" };
+        static const char* statusNames[] = { "Completed", "Failed" };
+        out += "Transaction ID: TXN";
+        out += std::to_string(record.transactionNumber);
+        out += ", Type: ";
+        out += typeNames[static_cast<int>(record.type)];
+        out += ", Amount: ";
+        out += record.amount.toString();
+        out += ", Status: ";
+        out += statusNames[static_cast<int>(record.status)];
+        out += ", Date: ";
+        out += formatDate(record.date);
+        out += ", Balance After: ";
+        out += record.balanceAfterTransaction.toString();
+    }
+
+    std::string getDetails(const TransactionRecord& record) const {
+        std::string details;
+        appendDetails(details, record);
+        return details;
+    }
 };
 
-class Withdrawal : public Transaction {
+// Little-endian encoding shared by the binary sink, the journal and snapshots
+template <typename T>
+void appendLittleEndian(std::string& out, T value) {
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        out += static_cast<char>((static_cast<std::uint64_t>(value) >> (8 * i)) & 0xFF);
+    }
+}
+
+template <typename T>
+T readLittleEndian(const char* data) {
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        value |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[i])) << (8 * i);
+    }
+    return static_cast<T>(value);
+}
+
+// A 2-byte length followed by the characters. Longer text cannot be encoded; BankSystem::addAccount keeps
+// account numbers well below the limit, so this only fires on a bug.
+void appendLengthPrefixed(std::string& out, const std::string& text) {
+    if (text.size() > 0xFFFF) throw std::length_error("Text too long for a 2-byte length prefix");
+    appendLittleEndian(out, static_cast<std::uint16_t>(text.size()));
+    out += text;
+}
+
+// --- Transaction Sinks ---
+// Sinks receive ranges of ledger records when BankSystem::flushSinks is called and do all formatting there,
+// so recording a transaction never builds a string.
+class TransactionSink {
 public:
-    Withdrawal(const std::string& transactionId, const std::string& accountNumber, double amount, const std::string& date, double balanceAfter)
-        : Transaction(transactionId, accountNumber, "Withdrawal", amount, "ATM Withdrawal", "Completed", date, balanceAfter) {}
+    virtual ~TransactionSink() = default;
+
+    // Consume records [from, to) of the ledger
+    virtual void write(const Ledger& ledger, std::size_t from, std::size_t to) = 0;
+    virtual void flush() = 0;
 };
 
-class Transfer : public Transaction {
+// Renders records as text lines into a buffer that is written out once it grows past the threshold or on flush
+class BufferedTextSink : public TransactionSink {
+private:
+    std::ostream& out;
+    std::string buffer;
+    std::size_t flushThreshold;
+
+public:
+    explicit BufferedTextSink(std::ostream& out, std::size_t flushThreshold = 64 * 1024)
+        : out(out), flushThreshold(flushThreshold) {
+        buffer.reserve(flushThreshold);
+    }
+
+    void write(const Ledger& ledger, std::size_t from, std::size_t to) override {
+        for (std::size_t i = from; i < to; ++i) {
+            ledger.appendDetails(buffer, ledger[i]);
+            buffer += '\n';
+            if (buffer.size() >= flushThreshold) {
+                flush();
+            }
+        }
+    }
+
+    void flush() override {
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        out.flush();
+        buffer.clear();
+    }
+};
+
+// Writes records in a fixed little-endian layout:
+// transaction number (8), amount cents (8), balance cents (8), type (1), status (1),
+// date as days since 1970-01-01 (4), then account and beneficiary, each as a 2-byte length followed by the characters.
+class BinaryTransactionSink : public TransactionSink {
+private:
+    std::ostream& out;
+    std::string buffer;
+
+public:
+    explicit BinaryTransactionSink(std::ostream& out) : out(out) {}
+
+    void write(const Ledger& ledger, std::size_t from, std::size_t to) override {
+        const StringPool& strings = ledger.getStrings();
+        for (std::size_t i = from; i < to; ++i) {
+            const TransactionRecord& record = ledger[i];
+            appendLittleEndian(buffer, record.transactionNumber);
+            appendLittleEndian(buffer, record.amount.toCents());
+            appendLittleEndian(buffer, record.balanceAfterTransaction.toCents());
+            appendLittleEndian(buffer, static_cast<std::uint8_t>(record.type));
+            appendLittleEndian(buffer, static_cast<std::uint8_t>(record.status));
+            appendLittleEndian(buffer, record.date);
+            appendLengthPrefixed(buffer, strings.get(record.accountId));
+            appendLengthPrefixed(buffer, strings.get(record.beneficiaryId));
+        }
+    }
+
+    void flush() override {
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        out.flush();
+        buffer.clear();
+    }
+};
+
+// --- Durable Journal and Snapshots ---
+// Every applied transaction (and every account opening) is appended to a binary journal. Every
+// snapshotInterval entries the balances are written to a snapshot together with the journal offset
+// they reflect, so recovery loads the snapshot and replays only the journal entries after it.
+
+// Thrown when the journal or a snapshot cannot be written. The operation being recorded has already been
+// applied in memory, so the caller must treat the store as no longer durable rather than retry the operation.
+class JournalError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// Flushing a stream only hands its data to the operating system, which can still lose it on power failure.
+// syncFile asks the system to put the file's data on the device (_commit on Windows, fsync elsewhere).
+bool syncFile(std::FILE* file) {
+    if (std::fflush(file) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return ::fsync(fileno(file)) == 0;
+#endif
+}
+
+// Make a newly created or renamed directory entry durable. POSIX needs the directory itself synced;
+// on Windows NTFS journals the entry, and renames go through MoveFileEx with MOVEFILE_WRITE_THROUGH.
+void syncDirectoryOf(const std::string& path) {
+#ifndef _WIN32
+    std::string directory = std::filesystem::path(path).parent_path().string();
+    int descriptor = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY);
+    bool synced = descriptor >= 0 && ::fsync(descriptor) == 0;
+    if (descriptor >= 0) ::close(descriptor);
+    if (!synced) throw JournalError("Cannot sync the directory of " + path);
+#else
+    (void)path;
+#endif
+}
+
+// Rename from over to, durably
+void replaceFile(const std::string& from, const std::string& to) {
+#ifdef _WIN32
+    if (!MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        throw JournalError("Cannot replace " + to);
+    }
+#else
+    std::error_code error;
+    std::filesystem::rename(from, to, error);
+    if (error) throw JournalError("Cannot replace " + to + ": " + error.message());
+    syncDirectoryOf(to);
+#endif
+}
+
+// Journal entry kinds; the first three match TransactionType
+enum class JournalEntryType : std::uint8_t { Deposit, Withdrawal, Transfer, AccountOpened };
+
+struct JournalEntry {
+    JournalEntryType type;
+    Money amount;          // opening balance for AccountOpened
+    std::int32_t date;     // days since 1970-01-01
+    std::string accountNumber;
     std::string beneficiaryAccount;
+    AccountKind kind = AccountKind::Savings; // AccountOpened only
+};
+
+// FNV-1a, used to detect a journal entry that was only partly written
+std::uint32_t checksum(const char* data, std::size_t size) {
+    std::uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * 16777619u;
+    }
+    return hash;
+}
+
+// Append-only journal file: an 8-byte magic, then entries of
+// payload length (2), payload (type 1, amount cents 8, date 4, account and beneficiary length-prefixed,
+// then for AccountOpened the account kind 1), checksum (4).
+// An AccountOpened entry without the kind byte was written before kinds were stored and opens a SavingsAccount.
+class BankJournal {
+private:
+    static constexpr char magic[9] = "BKJRNL01";
+    static constexpr std::size_t magicSize = 8;
+
+    std::FILE* file = nullptr;
+    std::string buffer;
+    std::uint64_t bytesWritten = 0;
 
 public:
-    Transfer(const std::string& transactionId, const std::string& accountNumber, double amount, const std::string& date, const std::string& beneficiaryAccount, double balanceAfter)
-        : Transaction(transactionId, accountNumber, "Transfer", amount, "Transfer to " + beneficiaryAccount, "Completed", date, balanceAfter), beneficiaryAccount(beneficiaryAccount) {}
+    explicit BankJournal(const std::string& path) {
+        std::error_code error;
+        bool isNew = !std::filesystem::exists(path, error) || std::filesystem::file_size(path, error) == 0;
+        file = std::fopen(path.c_str(), "ab");
+        if (file == nullptr) throw JournalError("Cannot open journal " + path);
+        if (isNew) {
+            if (std::fwrite(magic, 1, magicSize, file) != magicSize || !syncFile(file)) {
+                std::fclose(file);
+                throw JournalError("Cannot write journal " + path);
+            }
+            syncDirectoryOf(path);
+            bytesWritten = magicSize;
+        }
+        else {
+            bytesWritten = std::filesystem::file_size(path);
+        }
+    }
+
+    BankJournal(const BankJournal&) = delete;
+    BankJournal& operator=(const BankJournal&) = delete;
+
+    ~BankJournal() {
+        try {
+            flush();
+        }
+        catch (const JournalError&) {
+            // Nothing can be reported from a destructor; the entries are lost as in a crash
+        }
+        std::fclose(file);
+    }
+
+    void append(const JournalEntry& entry) {
+        std::string payload;
+        appendLittleEndian(payload, static_cast<std::uint8_t>(entry.type));
+        appendLittleEndian(payload, entry.amount.toCents());
+        appendLittleEndian(payload, entry.date);
+        appendLengthPrefixed(payload, entry.accountNumber);
+        appendLengthPrefixed(payload, entry.beneficiaryAccount);
+        if (entry.type == JournalEntryType::AccountOpened) {
+            appendLittleEndian(payload, static_cast<std::uint8_t>(entry.kind));
+        }
+        if (payload.size() > 0xFFFF) throw JournalError("Journal entry too large");
+
+        appendLittleEndian(buffer, static_cast<std::uint16_t>(payload.size()));
+        buffer += payload;
+        appendLittleEndian(buffer, checksum(payload.data(), payload.size()));
+    }
+
+    // Write buffered entries and wait until they are on the device
+    void flush() {
+        if (buffer.empty()) return;
+        if (std::fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size() || !syncFile(file)) {
+            throw JournalError("Cannot write journal");
+        }
+        bytesWritten += buffer.size();
+        buffer.clear();
+    }
+
+    // Size of the journal file once buffered entries are flushed
+    std::uint64_t size() const {
+        return bytesWritten + buffer.size();
+    }
+
+    // Visit the entries stored from offset onwards (0 means the first entry). Reading stops at the first
+    // entry that is cut short or fails its checksum; the offset just past the last good entry is returned.
+    template <typename Visitor>
+    static std::uint64_t replay(const std::string& path, std::uint64_t offset, Visitor visit) {
+        std::ifstream in(path, std::ios::binary);
+        char header[magicSize];
+        if (!in.read(header, magicSize) || std::string(header, magicSize) != std::string(magic, magicSize)) {
+            return 0;
+        }
+
+        std::uint64_t position = offset < magicSize ? magicSize : offset;
+        in.seekg(static_cast<std::streamoff>(position));
+        std::string payload;
+        char lengthBytes[2];
+        char checksumBytes[4];
+        while (in.read(lengthBytes, sizeof(lengthBytes))) {
+            std::uint16_t length = readLittleEndian<std::uint16_t>(lengthBytes);
+            payload.resize(length);
+            if (length < 17 || !in.read(&payload[0], length) || !in.read(checksumBytes, sizeof(checksumBytes))
+                || readLittleEndian<std::uint32_t>(checksumBytes) != checksum(payload.data(), payload.size())) {
+                break;
+            }
+
+            JournalEntry entry;
+            entry.type = static_cast<JournalEntryType>(payload[0]);
+            entry.amount = Money::fromCents(readLittleEndian<std::int64_t>(&payload[1]));
+            entry.date = readLittleEndian<std::int32_t>(&payload[9]);
+            std::size_t accountLength = readLittleEndian<std::uint16_t>(&payload[13]);
+            if (15 + accountLength + 2 > payload.size()) break;
+            entry.accountNumber.assign(payload, 15, accountLength);
+            std::size_t beneficiaryLength = readLittleEndian<std::uint16_t>(&payload[15 + accountLength]);
+            std::size_t entryEnd = 17 + accountLength + beneficiaryLength;
+            bool hasKind = entry.type == JournalEntryType::AccountOpened && entryEnd + 1 == payload.size();
+            if (entryEnd + (hasKind ? 1 : 0) != payload.size()) break;
+            entry.beneficiaryAccount.assign(payload, 17 + accountLength, beneficiaryLength);
+            if (hasKind) entry.kind = static_cast<AccountKind>(payload[entryEnd]);
+
+            visit(entry);
+            position += sizeof(lengthBytes) + length + sizeof(checksumBytes);
+        }
+        return position;
+    }
+};
+
+constexpr char BankJournal::magic[9];
+
+// Snapshot file: an 8-byte magic, journal offset (8), next transaction number (8), account count (8),
+// then per account its number (length-prefixed), balance in cents (8) and kind (1).
+// Version 01 snapshots have no kind byte; their accounts are SavingsAccounts.
+// Written to a temporary file, synced and renamed over the previous snapshot, so a crash or power loss leaves
+// either the old snapshot or the new one.
+struct BankSnapshot {
+    struct AccountState {
+        std::string accountNumber;
+        Money balance;
+        AccountKind kind;
+    };
+
+    std::uint64_t journalOffset = 0;
+    std::uint64_t nextTransactionNumber = 1;
+    std::vector<AccountState> accounts;
+
+    void save(const std::string& path) const {
+        std::string data = "BKSNAP02";
+        appendLittleEndian(data, journalOffset);
+        appendLittleEndian(data, nextTransactionNumber);
+        appendLittleEndian(data, static_cast<std::uint64_t>(accounts.size()));
+        for (const auto& account : accounts) {
+            appendLengthPrefixed(data, account.accountNumber);
+            appendLittleEndian(data, account.balance.toCents());
+            appendLittleEndian(data, static_cast<std::uint8_t>(account.kind));
+        }
+
+        std::string tempPath = path + ".tmp";
+        std::FILE* file = std::fopen(tempPath.c_str(), "wb");
+        if (file == nullptr) throw JournalError("Cannot create snapshot " + tempPath);
+        bool written = std::fwrite(data.data(), 1, data.size(), file) == data.size() && syncFile(file);
+        if (std::fclose(file) != 0 || !written) throw JournalError("Cannot write snapshot " + tempPath);
+        replaceFile(tempPath, path);
+    }
+
+    // Returns false when there is no readable snapshot
+    bool load(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        if (data.size() < 32 || (data.compare(0, 8, "BKSNAP01") != 0 && data.compare(0, 8, "BKSNAP02") != 0)) return false;
+        std::size_t kindSize = data.compare(0, 8, "BKSNAP02") == 0 ? 1 : 0;
+
+        journalOffset = readLittleEndian<std::uint64_t>(&data[8]);
+        nextTransactionNumber = readLittleEndian<std::uint64_t>(&data[16]);
+        std::uint64_t accountCount = readLittleEndian<std::uint64_t>(&data[24]);
+        accounts.clear();
+        std::size_t position = 32;
+        for (std::uint64_t i = 0; i < accountCount; ++i) {
+            if (position + 2 > data.size()) return false;
+            std::size_t length = readLittleEndian<std::uint16_t>(&data[position]);
+            if (position + 2 + length + 8 + kindSize > data.size()) return false;
+            AccountState account;
+            account.accountNumber.assign(data, position + 2, length);
+            account.balance = Money::fromCents(readLittleEndian<std::int64_t>(&data[position + 2 + length]));
+            account.kind = kindSize != 0 ? static_cast<AccountKind>(data[position + 2 + length + 8]) : AccountKind::Savings;
+            accounts.push_back(std::move(account));
+            position += 2 + length + 8 + kindSize;
+        }
+        return true;
+    }
+};
+
+// What BankSystem::openDurableStore found on disk
+struct RecoveryResult {
+    bool fromSnapshot = false;
+    std::size_t accountsRestored = 0;
+    std::size_t entriesReplayed = 0;
+};
+
+// One queued operation for BankSystem::processBatch
+struct BankOperation {
+    TransactionType type;
+    std::string accountNumber;
+    std::string toAccountNumber; // used by Transfer only
+    Money amount;
+    std::string date;
+};
+
+struct BatchResult {
+    std::size_t applied = 0;
+    std::size_t failed = 0;
 };
 
 // BankSystem class to manage accounts and process transactions
 class BankSystem {
 private:
     std::unordered_map<std::string, Account*> accounts;
-    std::vector<Transaction*> transactionHistory;
+    Ledger ledger;
+    std::vector<TransactionSink*> sinks;
+    std::size_t publishedRecords = 0; // ledger records already handed to the sinks
+
+    // Durable store, see openDurableStore
+    std::vector<std::unique_ptr<Account>> recoveredAccounts; // accounts re-created by recovery, owned by the bank
+    std::unique_ptr<BankJournal> journal;
+    std::string snapshotPath;
+    std::size_t snapshotInterval = 0;
+    std::size_t entriesSinceSnapshot = 0;
+    std::size_t syncEvery = 1;            // per-call operations per journal sync (group commit)
+    std::size_t operationsSinceSync = 0;
+
+    // Record an applied deposit or withdrawal in the ledger and, when durable, in the journal
+    void record(TransactionType type, const std::string& accountNumber, const std::string& beneficiaryAccount,
+        Money amount, std::int32_t day, Money balanceAfterTransaction) {
+        ledger.append(type, accountNumber, beneficiaryAccount, amount, day, balanceAfterTransaction);
+        journalEntry(type, accountNumber, beneficiaryAccount, amount, day);
+    }
+
+    // Record both sides of an applied transfer in the ledger and the transfer once in the journal
+    void recordTransfer(const Account& fromAccount, const Account& toAccount, Money amount, std::int32_t day) {
+        appendTransfer(fromAccount, toAccount, amount, day);
+        journalEntry(TransactionType::Transfer, fromAccount.getAccountNumber(), toAccount.getAccountNumber(), amount, day);
+    }
+
+    void appendTransfer(const Account& fromAccount, const Account& toAccount, Money amount, std::int32_t day) {
+        ledger.append(TransactionType::Transfer, fromAccount.getAccountNumber(), toAccount.getAccountNumber(), amount, day, fromAccount.getBalance());
+        ledger.append(TransactionType::TransferIn, toAccount.getAccountNumber(), fromAccount.getAccountNumber(), amount, day, toAccount.getBalance());
+    }
+
+    void journalEntry(TransactionType type, const std::string& accountNumber, const std::string& beneficiaryAccount, Money amount, std::int32_t day) {
+        if (journal) {
+            journal->append(JournalEntry{ static_cast<JournalEntryType>(type), amount, day, accountNumber, beneficiaryAccount });
+            if (++entriesSinceSnapshot >= snapshotInterval) {
+                saveSnapshot();
+            }
+        }
+    }
+
+    void flushJournal() {
+        if (journal) {
+            journal->flush();
+            operationsSinceSync = 0;
+        }
+    }
+
+    // Called after each per-call operation: sync once syncEvery operations are waiting
+    void commitOperation() {
+        if (journal && ++operationsSinceSync >= syncEvery) flushJournal();
+    }
+
+    void saveSnapshot() {
+        flushJournal();
+        BankSnapshot snapshot;
+        snapshot.journalOffset = journal->size();
+        snapshot.nextTransactionNumber = ledger.nextTransactionNumber();
+        snapshot.accounts.reserve(accounts.size());
+        for (const auto& account : accounts) {
+            snapshot.accounts.push_back(BankSnapshot::AccountState{ account.first, account.second->getBalance(), account.second->getKind() });
+        }
+        snapshot.save(snapshotPath);
+        entriesSinceSnapshot = 0;
+    }
+
+    Account* findOrCreateAccount(const std::string& accountNumber, Money balance, AccountKind kind) {
+        auto found = accounts.find(accountNumber);
+        if (found != accounts.end()) return found->second;
+        switch (kind) {
+        case AccountKind::Savings:
+            recoveredAccounts.emplace_back(new SavingsAccount(accountNumber, balance));
+            break;
+        default:
+            throw JournalError("Unknown account kind for " + accountNumber);
+        }
+        accounts[accountNumber] = recoveredAccounts.back().get();
+        return recoveredAccounts.back().get();
+    }
+
+    // Re-apply one journal entry; entries were valid when written, so they apply the same way again
+    void replay(const JournalEntry& entry) {
+        if (entry.type == JournalEntryType::AccountOpened) {
+            findOrCreateAccount(entry.accountNumber, entry.amount, entry.kind);
+            return;
+        }
+
+        Account* account = accounts.at(entry.accountNumber);
+        switch (entry.type) {
+        case JournalEntryType::Deposit:
+            account->deposit(entry.amount);
+            break;
+        case JournalEntryType::Withdrawal:
+            account->withdraw(entry.amount);
+            break;
+        default: {
+            Account* toAccount = accounts.at(entry.beneficiaryAccount);
+            account->transfer(*toAccount, entry.amount);
+            appendTransfer(*account, *toAccount, entry.amount, entry.date);
+            return;
+        }
+        }
+        ledger.append(static_cast<TransactionType>(entry.type), entry.accountNumber, entry.beneficiaryAccount,
+            entry.amount, entry.date, account->getBalance());
+    }
+
+    // Last account looked up, so a run of operations on one account hashes its number once
+    struct AccountLookupCache {
+        const std::string* accountNumber = nullptr;
+        Account* account = nullptr;
+    };
+
+    Account* lookupAccount(const std::string& accountNumber, AccountLookupCache& cache) const {
+        if (cache.accountNumber == nullptr || accountNumber != *cache.accountNumber) {
+            auto found = accounts.find(accountNumber);
+            cache.account = found != accounts.end() ? found->second : nullptr;
+            cache.accountNumber = &accountNumber;
+        }
+        return cache.account;
+    }
 
 public:
+    // Account numbers are stored with a 2-byte length in the journal and snapshots; this keeps entries far below it
+    static constexpr std::size_t maxAccountNumberLength = 256;
+
+    // Recover from the snapshot and journal at the given paths (if present), then journal every transaction
+    // and write a new snapshot every snapshotInterval entries. Call before adding accounts: accounts found on
+    // disk are re-created, with the class they were opened as, and owned by the bank.
+    // Per-call operations are synced to disk in groups of operationsPerSync (group commit): with more than one,
+    // an operation that has returned may be lost in a crash until the group fills or commit() is called.
+    // processBatch, addAccount and snapshots always sync before returning.
+    RecoveryResult openDurableStore(const std::string& journalPath, const std::string& snapshotFilePath, std::size_t interval,
+        std::size_t operationsPerSync = 1) {
+        if (interval == 0) throw std::invalid_argument("Snapshot interval must be positive");
+        if (operationsPerSync == 0) throw std::invalid_argument("Operations per sync must be positive");
+
+        RecoveryResult result;
+        BankSnapshot snapshot;
+        if (snapshot.load(snapshotFilePath)) {
+            result.fromSnapshot = true;
+            ledger.startNumberingAt(snapshot.nextTransactionNumber);
+            for (const auto& account : snapshot.accounts) {
+                findOrCreateAccount(account.accountNumber, account.balance, account.kind)->restoreBalance(account.balance);
+            }
+            result.accountsRestored = snapshot.accounts.size();
+        }
+
+        std::uint64_t validEnd = BankJournal::replay(journalPath, snapshot.journalOffset, [&](const JournalEntry& entry) {
+            replay(entry);
+            ++result.entriesReplayed;
+        });
+
+        // Drop a partly written entry left by a crash so new entries follow the last good one
+        std::error_code error;
+        if (validEnd > 0 && std::filesystem::exists(journalPath, error) && std::filesystem::file_size(journalPath) > validEnd) {
+            std::filesystem::resize_file(journalPath, validEnd);
+        }
+
+        journal.reset(new BankJournal(journalPath));
+        snapshotPath = snapshotFilePath;
+        snapshotInterval = interval;
+        entriesSinceSnapshot = result.entriesReplayed;
+        syncEvery = operationsPerSync;
+        return result;
+    }
+
+    // Sync every journaled operation to disk now
+    void commit() {
+        flushJournal();
+    }
+
     void addAccount(Account* account) {
-        accounts[account->getAccountNumber()] = account;
+        if (account->getAccountNumber().size() > maxAccountNumberLength) {
+            throw std::invalid_argument("Account number longer than " + std::to_string(maxAccountNumberLength) + " characters");
+        }
+        if (!accounts.emplace(account->getAccountNumber(), account).second) {
+            throw std::invalid_argument("Account " + account->getAccountNumber() + " already exists");
+        }
+        if (journal) {
+            journal->append(JournalEntry{ JournalEntryType::AccountOpened, account->getBalance(), 0, account->getAccountNumber(), "",
+                account->getKind() });
+            flushJournal();
+        }
     }
 
-    void processDeposit(const std::string& accountNumber, double amount, const std::string& date) {
+    Money getTotalBalance() const {
+        Money total;
+        for (const auto& account : accounts) {
+            total += account.second->getBalance();
+        }
+        return total;
+    }
+
+    void processDeposit(const std::string& accountNumber, Money amount, const std::string& date) {
+        std::int32_t day = parseDate(date);
         Account* account = accounts.at(accountNumber);
         account->deposit(amount);
-        double newBalance = account->getBalance();
-        Deposit* deposit = new Deposit("TXN" + std::to_string(transactionHistory.size() + 1), accountNumber, amount, date, newBalance);
-        transactionHistory.push_back(deposit);
-        std::cout << deposit->getDetails() << std::endl;
+        record(TransactionType::Deposit, accountNumber, "", amount, day, account->getBalance());
+        commitOperation();
     }
 
-    void processWithdrawal(const std::string& accountNumber, double amount, const std::string& date) {
+    void processWithdrawal(const std::string& accountNumber, Money amount, const std::string& date) {
+        std::int32_t day = parseDate(date);
         Account* account = accounts.at(accountNumber);
         account->withdraw(amount);
-        double newBalance = account->getBalance();
-        Withdrawal* withdrawal = new Withdrawal("TXN" + std::to_string(transactionHistory.size() + 1), accountNumber, amount, date, newBalance);
-        transactionHistory.push_back(withdrawal);
-        std::cout << withdrawal->getDetails() << std::endl;
+        record(TransactionType::Withdrawal, accountNumber, "", amount, day, account->getBalance());
+        commitOperation();
     }
 
-    void processTransfer(const std::string& fromAccountNumber, const std::string& toAccountNumber, double amount, const std::string& date) {
+    void processTransfer(const std::string& fromAccountNumber, const std::string& toAccountNumber, Money amount, const std::string& date) {
+        std::int32_t day = parseDate(date);
         Account* fromAccount = accounts.at(fromAccountNumber);
         Account* toAccount = accounts.at(toAccountNumber);
         fromAccount->transfer(*toAccount, amount);
-        double newBalance = fromAccount->getBalance();
-        Transfer* transfer = new Transfer("TXN" + std::to_string(transactionHistory.size() + 1), fromAccountNumber, amount, date, toAccountNumber, newBalance);
-        transactionHistory.push_back(transfer);
-        std::cout << transfer->getDetails() << std::endl;
+        recordTransfer(*fromAccount, *toAccount, amount, day);
+        commitOperation();
+    }
+
+    // Apply a batch of operations in one pass, in submission order so every withdrawal sees the same balance
+    // as the per-call path. The ledger is grown once for the whole batch and the journal flushed once at the end;
+    // consecutive operations on the same account reuse its lookup, and on the same date its parsed day.
+    // Operations that fail (unknown account, insufficient funds) are counted and skipped. A JournalError from
+    // recording or snapshotting is not an operation failure: it ends the batch and propagates to the caller.
+    BatchResult processBatch(const BankOperation* operations, std::size_t count) {
+        // A transfer adds a record on each side
+        ledger.reserve(count + std::count_if(operations, operations + count,
+            [](const BankOperation& operation) { return operation.type == TransactionType::Transfer; }));
+
+        AccountLookupCache fromCache, toCache;
+        const std::string* lastDate = nullptr;
+        std::int32_t lastDay = 0;
+        BatchResult result;
+        for (std::size_t i = 0; i < count; ++i) {
+            const BankOperation& operation = operations[i];
+            Account* account = lookupAccount(operation.accountNumber, fromCache);
+            Account* toAccount = operation.type == TransactionType::Transfer ? lookupAccount(operation.toAccountNumber, toCache) : nullptr;
+
+            try {
+                if (account == nullptr || (operation.type == TransactionType::Transfer && toAccount == nullptr)) {
+                    throw std::invalid_argument("Unknown account");
+                }
+                if (lastDate == nullptr || operation.date != *lastDate) {
+                    lastDay = parseDate(operation.date);
+                    lastDate = &operation.date;
+                }
+
+                switch (operation.type) {
+                case TransactionType::Deposit:
+                    account->deposit(operation.amount);
+                    break;
+                case TransactionType::Withdrawal:
+                    account->withdraw(operation.amount);
+                    break;
+                case TransactionType::Transfer:
+                    account->transfer(*toAccount, operation.amount);
+                    break;
+                default:
+                    throw std::invalid_argument("Transfer In and Refund are recorded by the engine, not submitted");
+                }
+            }
+            catch (const std::exception&) {
+                ++result.failed;
+                continue;
+            }
+            if (operation.type == TransactionType::Transfer) {
+                recordTransfer(*account, *toAccount, operation.amount, lastDay);
+            }
+            else {
+                record(operation.type, operation.accountNumber, "", operation.amount, lastDay, account->getBalance());
+            }
+            ++result.applied;
+        }
+        flushJournal();
+        return result;
+    }
+
+    BatchResult processBatch(const std::vector<BankOperation>& operations) {
+        return processBatch(operations.data(), operations.size());
+    }
+
+    void addSink(TransactionSink* sink) {
+        sinks.push_back(sink);
     }
 
-    // Retrieve all transactions
+    // Hand every transaction recorded since the last call to each sink and flush them
+    void flushSinks() {
+        std::size_t recorded = ledger.size();
+        for (TransactionSink* sink : sinks) {
+            sink->write(ledger, publishedRecords, recorded);
+            sink->flush();
+        }
+        publishedRecords = recorded;
+    }
+
+    // Print the transactions of one account dated between fromDate and toDate inclusive (YYYY-MM-DD)
+    void printStatement(const std::string& accountNumber, const std::string& fromDate, const std::string& toDate) const {
+        std::string statement;
+        ledger.forEachInRange(accountNumber, parseDate(fromDate), parseDate(toDate), [&](const TransactionRecord& record) {
+            ledger.appendDetails(statement, record);
+            statement += '\n';
+        });
+        std::cout << statement;
+    }
+
+    // Retrieve all transactions, one line each, flushing once at the end
     void getTransactionHistory() const {
-        for (const auto& txn : transactionHistory) {
-            std::cout << txn->getDetails() << std::endl;
+        std::string line;
+        ledger.forEach([this, &line](const TransactionRecord& record) {
+            line.clear();
+            ledger.appendDetails(line, record);
+            line += '\n';
+            std::cout << line;
+        });
+        std::cout.flush();
+    }
+};
+
+// --- Sharded Bank Engine ---
+// Accounts are partitioned across shards by a hash of the account number. Each shard owns its accounts and its
+// own ledger segment, and only the shard's worker thread ever touches them, so account and ledger updates take
+// no locks; the shard's task queue is the only shared structure.
+// A transfer between shards is a debit followed by a credit, not an atomic commit: the source shard debits and
+// records a Transfer, then the destination shard credits and records a TransferIn, so each shard's ledger holds
+// its own side. Between the two steps the amount is in flight and counted in neither balance. If the credit
+// cannot be applied, the source shard refunds the debit (a compensating step), records the refund as a Refund
+// record and marks its Transfer record failed.
+// processBatch queues one task per shard for a whole batch instead of one per operation.
+class ShardedBankSystem {
+private:
+    struct Shard {
+        std::unordered_map<std::string, Account*> accounts;
+        Ledger ledger;
+        std::deque<std::function<void()>> tasks;
+        std::mutex tasksMutex;
+        std::condition_variable tasksReady;
+        bool stopping = false;
+        std::thread worker;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::atomic<std::size_t> pendingTasks{ 0 };
+    std::mutex idleMutex;
+    std::condition_variable idle;
+    std::atomic<std::size_t> appliedCount{ 0 };
+    std::atomic<std::size_t> failedCount{ 0 };
+
+    static Account* findAccount(Shard& shard, const std::string& accountNumber) {
+        auto found = shard.accounts.find(accountNumber);
+        return found != shard.accounts.end() ? found->second : nullptr;
+    }
+
+    void submit(std::size_t shardIndex, std::function<void()> task) {
+        pendingTasks.fetch_add(1);
+        Shard& shard = *shards[shardIndex];
+        {
+            std::lock_guard<std::mutex> lock(shard.tasksMutex);
+            shard.tasks.push_back(std::move(task));
         }
+        shard.tasksReady.notify_one();
+    }
+
+    // One operation of a processBatch call, with its date already parsed
+    struct ShardOperation {
+        TransactionType type;
+        std::string accountNumber;
+        std::string toAccountNumber;
+        Money amount;
+        std::int32_t day;
+    };
+
+    // The apply* functions run on the worker of shard index, which owns the account being debited or credited
+    void applyDeposit(std::size_t index, const std::string& accountNumber, Money amount, std::int32_t day) {
+        Shard& shard = *shards[index];
+        Account* account = findAccount(shard, accountNumber);
+        if (account == nullptr) {
+            ++failedCount;
+            return;
+        }
+        account->deposit(amount);
+        shard.ledger.append(TransactionType::Deposit, accountNumber, "", amount, day, account->getBalance());
+        ++appliedCount;
+    }
+
+    void applyWithdrawal(std::size_t index, const std::string& accountNumber, Money amount, std::int32_t day) {
+        Shard& shard = *shards[index];
+        Account* account = findAccount(shard, accountNumber);
+        try {
+            if (account == nullptr) throw std::invalid_argument("Unknown account");
+            account->withdraw(amount);
+        }
+        catch (const std::exception&) {
+            ++failedCount;
+            return;
+        }
+        shard.ledger.append(TransactionType::Withdrawal, accountNumber, "", amount, day, account->getBalance());
+        ++appliedCount;
+    }
+
+    void applyTransfer(std::size_t fromIndex, const std::string& fromAccountNumber, const std::string& toAccountNumber,
+        Money amount, std::int32_t day) {
+        std::size_t toIndex = shardOf(toAccountNumber);
+        Shard& shard = *shards[fromIndex];
+        Account* fromAccount = findAccount(shard, fromAccountNumber);
+        Account* toAccount = fromIndex == toIndex ? findAccount(shard, toAccountNumber) : nullptr;
+        try {
+            if (fromAccount == nullptr || (fromIndex == toIndex && toAccount == nullptr)) {
+                throw std::invalid_argument("Unknown account");
+            }
+            if (toAccount != nullptr) {
+                fromAccount->transfer(*toAccount, amount);
+            }
+            else {
+                // Debit the source on its own shard
+                fromAccount->withdraw(amount);
+            }
+        }
+        catch (const std::exception&) {
+            ++failedCount;
+            return;
+        }
+
+        std::size_t recordIndex = shard.ledger.size();
+        shard.ledger.append(TransactionType::Transfer, fromAccountNumber, toAccountNumber, amount, day, fromAccount->getBalance());
+        if (toAccount != nullptr) {
+            shard.ledger.append(TransactionType::TransferIn, toAccountNumber, fromAccountNumber, amount, day, toAccount->getBalance());
+            ++appliedCount;
+            return;
+        }
+
+        // Credit the destination on its shard, or hand the money back to the source
+        submit(toIndex, [this, fromIndex, toIndex, fromAccount, fromAccountNumber, toAccountNumber, amount, day, recordIndex] {
+            Shard& toShard = *shards[toIndex];
+            Account* creditAccount = findAccount(toShard, toAccountNumber);
+            if (creditAccount != nullptr) {
+                creditAccount->deposit(amount);
+                toShard.ledger.append(TransactionType::TransferIn, toAccountNumber, fromAccountNumber, amount, day, creditAccount->getBalance());
+                ++appliedCount;
+                return;
+            }
+            submit(fromIndex, [this, fromIndex, fromAccount, fromAccountNumber, toAccountNumber, amount, day, recordIndex] {
+                Ledger& ledger = shards[fromIndex]->ledger;
+                fromAccount->deposit(amount);
+                ledger.markFailed(recordIndex);
+                ledger.append(TransactionType::Refund, fromAccountNumber, toAccountNumber, amount, day, fromAccount->getBalance());
+                ++failedCount;
+            });
+        });
+    }
+
+    // Worker loop: take everything queued in one go, then run it without holding the queue lock
+    void run(Shard& shard) {
+        std::deque<std::function<void()>> batch;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(shard.tasksMutex);
+                shard.tasksReady.wait(lock, [&shard] { return shard.stopping || !shard.tasks.empty(); });
+                if (shard.tasks.empty()) return;
+                batch.swap(shard.tasks);
+            }
+            for (auto& task : batch) {
+                task();
+                if (pendingTasks.fetch_sub(1) == 1) {
+                    std::lock_guard<std::mutex> lock(idleMutex);
+                    idle.notify_all();
+                }
+            }
+            batch.clear();
+        }
+    }
+
+public:
+    explicit ShardedBankSystem(std::size_t shardCount) {
+        if (shardCount == 0) throw std::invalid_argument("At least one shard is required");
+        for (std::size_t i = 0; i < shardCount; ++i) {
+            shards.emplace_back(new Shard());
+        }
+        for (auto& shard : shards) {
+            Shard* shardPtr = shard.get();
+            shard->worker = std::thread([this, shardPtr] { run(*shardPtr); });
+        }
+    }
+
+    ShardedBankSystem(const ShardedBankSystem&) = delete;
+    ShardedBankSystem& operator=(const ShardedBankSystem&) = delete;
+
+    // Finishes all queued work before the workers stop
+    ~ShardedBankSystem() {
+        waitUntilIdle();
+        for (auto& shard : shards) {
+            {
+                std::lock_guard<std::mutex> lock(shard->tasksMutex);
+                shard->stopping = true;
+            }
+            shard->tasksReady.notify_one();
+        }
+        for (auto& shard : shards) {
+            shard->worker.join();
+        }
+    }
+
+    std::size_t getShardCount() const {
+        return shards.size();
+    }
+
+    std::size_t shardOf(const std::string& accountNumber) const {
+        return std::hash<std::string>()(accountNumber) % shards.size();
+    }
+
+    void addAccount(Account* account) {
+        std::size_t index = shardOf(account->getAccountNumber());
+        submit(index, [this, index, account] {
+            shards[index]->accounts[account->getAccountNumber()] = account;
+        });
+    }
+
+    // The process* calls only validate the date and queue the operation; outcomes are counted in getResult()
+    void processDeposit(const std::string& accountNumber, Money amount, const std::string& date) {
+        std::int32_t day = parseDate(date);
+        std::size_t index = shardOf(accountNumber);
+        submit(index, [this, index, accountNumber, amount, day] {
+            applyDeposit(index, accountNumber, amount, day);
+        });
+    }
+
+    void processWithdrawal(const std::string& accountNumber, Money amount, const std::string& date) {
+        std::int32_t day = parseDate(date);
+        std::size_t index = shardOf(accountNumber);
+        submit(index, [this, index, accountNumber, amount, day] {
+            applyWithdrawal(index, accountNumber, amount, day);
+        });
+    }
+
+    void processTransfer(const std::string& fromAccountNumber, const std::string& toAccountNumber, Money amount, const std::string& date) {
+        std::int32_t day = parseDate(date);
+        std::size_t fromIndex = shardOf(fromAccountNumber);
+        submit(fromIndex, [this, fromIndex, fromAccountNumber, toAccountNumber, amount, day] {
+            applyTransfer(fromIndex, fromAccountNumber, toAccountNumber, amount, day);
+        });
+    }
+
+    // Sort a batch by source shard and queue one task per shard, so the submitting thread takes each queue lock
+    // once per batch. Operations on one shard run in submission order; an operation with an invalid date
+    // throws before anything is queued.
+    void processBatch(const BankOperation* operations, std::size_t count) {
+        std::vector<std::vector<ShardOperation>> byShard(shards.size());
+        const std::string* lastDate = nullptr;
+        std::int32_t lastDay = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            const BankOperation& operation = operations[i];
+            if (lastDate == nullptr || operation.date != *lastDate) {
+                lastDay = parseDate(operation.date);
+                lastDate = &operation.date;
+            }
+            byShard[shardOf(operation.accountNumber)].push_back(
+                ShardOperation{ operation.type, operation.accountNumber, operation.toAccountNumber, operation.amount, lastDay });
+        }
+
+        for (std::size_t index = 0; index < byShard.size(); ++index) {
+            if (byShard[index].empty()) continue;
+            auto batch = std::make_shared<std::vector<ShardOperation>>(std::move(byShard[index]));
+            submit(index, [this, index, batch] {
+                for (const ShardOperation& operation : *batch) {
+                    switch (operation.type) {
+                    case TransactionType::Deposit:
+                        applyDeposit(index, operation.accountNumber, operation.amount, operation.day);
+                        break;
+                    case TransactionType::Withdrawal:
+                        applyWithdrawal(index, operation.accountNumber, operation.amount, operation.day);
+                        break;
+                    case TransactionType::Transfer:
+                        applyTransfer(index, operation.accountNumber, operation.toAccountNumber, operation.amount, operation.day);
+                        break;
+                    default:
+                        ++failedCount; // Transfer In and Refund are recorded by the engine, not submitted
+                        break;
+                    }
+                }
+            });
+        }
+    }
+
+    void processBatch(const std::vector<BankOperation>& operations) {
+        processBatch(operations.data(), operations.size());
+    }
+
+    // Block until every queued operation, including the credit side of cross-shard transfers, has run
+    void waitUntilIdle() {
+        std::unique_lock<std::mutex> lock(idleMutex);
+        idle.wait(lock, [this] { return pendingTasks.load() == 0; });
+    }
+
+    Money getBalance(const std::string& accountNumber) {
+        std::size_t index = shardOf(accountNumber);
+        auto balance = std::make_shared<std::promise<Money>>();
+        std::future<Money> result = balance->get_future();
+        submit(index, [this, index, accountNumber, balance] {
+            Account* account = findAccount(*shards[index], accountNumber);
+            if (account != nullptr) {
+                balance->set_value(account->getBalance());
+            }
+            else {
+                balance->set_exception(std::make_exception_ptr(std::invalid_argument("Unknown account " + accountNumber)));
+            }
+        });
+        return result.get();
+    }
+
+    // Operations completed and failed so far
+    BatchResult getResult() const {
+        BatchResult result;
+        result.applied = appliedCount.load();
+        result.failed = failedCount.load();
+        return result;
+    }
+
+    // Retrieve all transactions, shard by shard
+    void getTransactionHistory() {
+        waitUntilIdle();
+        for (std::size_t i = 0; i < shards.size(); ++i) {
+            const Ledger& ledger = shards[i]->ledger;
+            std::cout << "Shard " << i << ":\n";
+            std::string line;
+            ledger.forEach([&ledger, &line](const TransactionRecord& record) {
+                line.clear();
+                ledger.appendDetails(line, record);
+                line += '\n';
+                std::cout << line;
+            });
+        }
+        std::cout.flush();
     }
 };
 
+// The layout the Ledger replaced: one heap object per transaction, held by pointer, every field but the amounts a string
+class LegacyTransaction {
+public:
+    std::string transactionId;
+    std::string accountNumber;
+    std::string type;
+    double amount;
+    std::string description;
+    std::string status;
+    std::string date;
+    double balanceAfterTransaction;
+    std::string beneficiaryAccount;
+
+    virtual ~LegacyTransaction() {}
+};
+
+// Store the same transactions as LegacyTransaction objects and in a Ledger, then print the bytes per transaction
+// and how fast a full scan (the total of all deposits) runs over each. One deposit, withdrawal or transfer
+// in turn over 10,000 accounts. Legacy bytes are the object, its pointer and string buffers too long for the
+// small-string buffer, without allocator overhead; ledger bytes are the record chunks and the per-account index.
+void runLedgerBenchmark(std::size_t recordCount) {
+    const std::size_t accountCount = 10000;
+    static const char* typeNames[] = { "Deposit", "Withdrawal", "Transfer" };
+    static const char* descriptions[] = { "Cash Deposit", "ATM Withdrawal" };
+    const std::size_t inlineCapacity = std::string().capacity();
+    auto stringBytes = [inlineCapacity](const std::string& text) {
+        return text.capacity() > inlineCapacity ? text.capacity() + 1 : 0;
+    };
+
+    double legacyBytes = 0, legacySeconds = 0, legacyTotal = 0;
+    {
+        std::vector<LegacyTransaction*> transactions;
+        transactions.reserve(recordCount);
+        for (std::size_t i = 0; i < recordCount; ++i) {
+            std::size_t kind = i % 3;
+            LegacyTransaction* transaction = new LegacyTransaction();
+            transaction->transactionId = "TXN" + std::to_string(i + 1);
+            transaction->accountNumber = "ACC" + std::to_string(i % accountCount);
+            transaction->type = typeNames[kind];
+            transaction->amount = 100.0;
+            transaction->status = "Completed";
+            transaction->date = "2024-10-04";
+            transaction->balanceAfterTransaction = 1000.0;
+            if (kind == 2) {
+                transaction->beneficiaryAccount = "ACC" + std::to_string((i + 7) % accountCount);
+                transaction->description = "Transfer to " + transaction->beneficiaryAccount;
+            }
+            else {
+                transaction->description = descriptions[kind];
+            }
+            transactions.push_back(transaction);
+        }
+
+        for (const LegacyTransaction* transaction : transactions) {
+            legacyBytes += sizeof(LegacyTransaction) + sizeof(LegacyTransaction*) + stringBytes(transaction->transactionId)
+                + stringBytes(transaction->accountNumber) + stringBytes(transaction->type) + stringBytes(transaction->description)
+                + stringBytes(transaction->status) + stringBytes(transaction->date) + stringBytes(transaction->beneficiaryAccount);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (const LegacyTransaction* transaction : transactions) {
+            if (transaction->type == "Deposit") legacyTotal += transaction->amount;
+        }
+        legacySeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        for (LegacyTransaction* transaction : transactions) delete transaction;
+    }
+
+    double ledgerBytes = 0, ledgerSeconds = 0;
+    Money ledgerTotal;
+    {
+        std::vector<std::string> accountNumbers;
+        for (std::size_t i = 0; i < accountCount; ++i) accountNumbers.push_back("ACC" + std::to_string(i));
+        std::int32_t day = parseDate("2024-10-04");
+
+        Ledger ledger;
+        ledger.reserve(recordCount);
+        for (std::size_t i = 0; i < recordCount; ++i) {
+            std::size_t kind = i % 3;
+            ledger.append(static_cast<TransactionType>(kind), accountNumbers[i % accountCount],
+                kind == 2 ? accountNumbers[(i + 7) % accountCount] : std::string(), Money::fromCents(10000), day, Money::fromCents(100000));
+        }
+        ledgerBytes = static_cast<double>(ledger.memoryUsage());
+
+        auto start = std::chrono::steady_clock::now();
+        ledger.forEach([&ledgerTotal](const TransactionRecord& record) {
+            if (record.type == TransactionType::Deposit) ledgerTotal += record.amount;
+        });
+        ledgerSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::cout << "\nLedger benchmark, " << recordCount << " transactions: legacy objects " << legacyBytes / recordCount
+        << " bytes each, scan " << recordCount / legacySeconds / 1e6 << "M/s; ledger " << ledgerBytes / recordCount
+        << " bytes each, scan " << recordCount / ledgerSeconds / 1e6 << "M/s; deposit totals "
+        << (Money::fromDouble(legacyTotal) == ledgerTotal ? "match" : "differ") << std::endl;
+}
+
+// Time the same deposits with logging off, with the text and binary sinks flushed every 10,000 operations,
+// and with the text sink flushed after every operation, which formats and flushes each transaction as it is
+// recorded like the old std::endl logging did.
+// Log files go to the temporary directory and are removed afterwards.
+void runLoggingBenchmark(std::size_t operationCount) {
+    const std::size_t accountCount = 10000;
+    const std::size_t flushEvery = 10000;
+    std::string textPath = (std::filesystem::temp_directory_path() / "bank_benchmark.log").string();
+    std::string binaryPath = (std::filesystem::temp_directory_path() / "bank_benchmark.bin").string();
+
+    enum class Logging { Off, Sinks, PerTransaction };
+    auto runMode = [&](Logging logging) {
+        BankSystem bank;
+        std::vector<std::unique_ptr<SavingsAccount>> accounts;
+        std::vector<std::string> accountNumbers;
+        for (std::size_t i = 0; i < accountCount; ++i) {
+            accounts.emplace_back(new SavingsAccount("LOG" + std::to_string(i), Money::fromDouble(1000.0)));
+            accountNumbers.push_back(accounts.back()->getAccountNumber());
+            bank.addAccount(accounts.back().get());
+        }
+
+        std::ofstream textLog(textPath);
+        std::ofstream binaryLog(binaryPath, std::ios::binary);
+        BufferedTextSink textSink(textLog);
+        BinaryTransactionSink binarySink(binaryLog);
+        if (logging != Logging::Off) {
+            bank.addSink(&textSink);
+        }
+        if (logging == Logging::Sinks) {
+            bank.addSink(&binarySink);
+        }
+
+        // Flushing the text sink after every operation formats and flushes each record as it is recorded
+        std::size_t interval = logging == Logging::PerTransaction ? 1 : flushEvery;
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < operationCount; ++i) {
+            bank.processDeposit(accountNumbers[i % accountCount], Money::fromCents(100), "2024-10-04");
+            if (logging != Logging::Off && (i + 1) % interval == 0) {
+                bank.flushSinks();
+            }
+        }
+        bank.flushSinks();
+        return operationCount / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    double offRate = runMode(Logging::Off);
+    double sinkRate = runMode(Logging::Sinks);
+    double eagerRate = runMode(Logging::PerTransaction);
+    std::filesystem::remove(textPath);
+    std::filesystem::remove(binaryPath);
+    std::cout << "\nLogging benchmark, " << operationCount << " deposits: logging off " << offRate / 1e6 << "M ops/s, sinks "
+        << sinkRate / 1e6 << "M ops/s, text flushed per transaction " << eagerRate / 1e6 << "M ops/s" << std::endl;
+}
+
+// Transfer throughput of ShardedBankSystem as the shard count doubles, submitting one operation at a time and in
+// batches of 10,000. 8,000 accounts in all; 90% of the transfers stay on one shard, as in the demo. A single thread
+// submits everything, so the per-call rate includes its queue locking and std::function allocation per operation.
+void runShardBenchmark(std::size_t transferCount) {
+    const std::size_t accountCount = 8000;
+    const std::size_t batchSize = 10000;
+    unsigned maxShards = std::max(8u, std::thread::hardware_concurrency());
+
+    auto runShards = [&](std::size_t shardCount, bool batched, bool& conserved) {
+        std::vector<std::unique_ptr<SavingsAccount>> accounts;
+        std::vector<BankOperation> operations;
+        double seconds;
+        {
+            ShardedBankSystem sharded(shardCount);
+            std::vector<std::vector<std::string>> accountsByShard(shardCount);
+            for (std::size_t i = 0; i < accountCount; ++i) {
+                accounts.emplace_back(new SavingsAccount("SCL" + std::to_string(i), Money::fromDouble(1000.0)));
+                sharded.addAccount(accounts.back().get());
+                accountsByShard[sharded.shardOf(accounts.back()->getAccountNumber())].push_back(accounts.back()->getAccountNumber());
+            }
+
+            std::uint32_t seed = 777;
+            auto nextRandom = [&seed] { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+            operations.reserve(transferCount);
+            for (std::size_t i = 0; i < transferCount; ++i) {
+                std::size_t fromShard = i % shardCount;
+                std::size_t toShard = shardCount > 1 && nextRandom() % 10 == 0 ? (fromShard + 1 + nextRandom() % (shardCount - 1)) % shardCount : fromShard;
+                const auto& fromList = accountsByShard[fromShard];
+                const auto& toList = accountsByShard[toShard];
+                operations.push_back(BankOperation{ TransactionType::Transfer, fromList[nextRandom() % fromList.size()],
+                    toList[nextRandom() % toList.size()], Money::fromCents(100), "2024-10-02" });
+            }
+            sharded.waitUntilIdle();
+
+            auto start = std::chrono::steady_clock::now();
+            if (batched) {
+                for (std::size_t first = 0; first < operations.size(); first += batchSize) {
+                    sharded.processBatch(operations.data() + first, std::min(batchSize, operations.size() - first));
+                }
+            }
+            else {
+                for (const BankOperation& operation : operations) {
+                    sharded.processTransfer(operation.accountNumber, operation.toAccountNumber, operation.amount, operation.date);
+                }
+            }
+            sharded.waitUntilIdle();
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        Money total;
+        for (const auto& account : accounts) total += account->getBalance();
+        conserved &= total == Money::fromDouble(1000.0) * static_cast<std::int64_t>(accountCount);
+        return static_cast<long long>(transferCount / seconds);
+    };
+
+    bool conserved = true;
+    std::cout << "\nSharded transfers, " << transferCount << " per run (transfers/sec), " << std::thread::hardware_concurrency()
+        << " hardware threads:\n  shards   per call   batches of " << batchSize << "\n";
+    for (std::size_t shardCount = 1; shardCount <= maxShards; shardCount *= 2) {
+        long long perCall = runShards(shardCount, false, conserved);
+        long long batched = runShards(shardCount, true, conserved);
+        std::cout << "  " << shardCount << "\t   " << perCall << "\t      " << batched << "\n";
+    }
+    std::cout << "  total balance " << (conserved ? "matches" : "differs") << std::endl;
+}
+
+// Durable throughput: the same transfers through the per-call methods with a sync after every 1, 16 and 256
+// operations, and through processBatch, which syncs once per batch. Files go to the system temp directory.
+void runDurableBenchmark(std::size_t transferCount) {
+    const std::size_t accountCount = 100;
+    const std::size_t batchSize = 256;
+    const std::filesystem::path directory = std::filesystem::temp_directory_path();
+    const std::string journalPath = (directory / "bank_benchmark.journal").string();
+    const std::string snapshotPath = (directory / "bank_benchmark.snap").string();
+
+    // operationsPerSync == 0 runs the batch path
+    auto runDurable = [&](std::size_t operationsPerSync, bool& recovered) {
+        std::filesystem::remove(journalPath);
+        std::filesystem::remove(snapshotPath);
+        std::vector<BankOperation> operations;
+        operations.reserve(transferCount);
+        for (std::size_t i = 0; i < transferCount; ++i) {
+            operations.push_back(BankOperation{ TransactionType::Transfer, "DBN" + std::to_string(i % accountCount),
+                "DBN" + std::to_string((i * 7 + 3) % accountCount), Money::fromCents(100), "2024-10-03" });
+        }
+
+        std::vector<std::unique_ptr<SavingsAccount>> accounts;
+        Money total;
+        double seconds;
+        {
+            BankSystem bank;
+            bank.openDurableStore(journalPath, snapshotPath, 100000, operationsPerSync == 0 ? 1 : operationsPerSync);
+            for (std::size_t i = 0; i < accountCount; ++i) {
+                accounts.emplace_back(new SavingsAccount("DBN" + std::to_string(i), Money::fromDouble(1000.0)));
+                bank.addAccount(accounts.back().get());
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            if (operationsPerSync == 0) {
+                for (std::size_t first = 0; first < operations.size(); first += batchSize) {
+                    bank.processBatch(operations.data() + first, std::min(batchSize, operations.size() - first));
+                }
+            }
+            else {
+                for (const BankOperation& operation : operations) {
+                    bank.processTransfer(operation.accountNumber, operation.toAccountNumber, operation.amount, operation.date);
+                }
+                bank.commit();
+            }
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            total = bank.getTotalBalance();
+        }
+
+        // Every account and transfer must come back: one journal entry each
+        BankSystem recoveredBank;
+        RecoveryResult recovery = recoveredBank.openDurableStore(journalPath, snapshotPath, 100000);
+        recovered &= recoveredBank.getTotalBalance() == total && recovery.entriesReplayed == accountCount + transferCount;
+        std::filesystem::remove(journalPath);
+        std::filesystem::remove(snapshotPath);
+        return static_cast<long long>(transferCount / seconds);
+    };
+
+    bool recovered = true;
+    std::cout << "\nDurable transfers, " << transferCount << " per run (transfers/sec):\n";
+    for (std::size_t operationsPerSync : { 1, 16, 256 }) {
+        std::cout << "  per call, sync every " << operationsPerSync << "\t" << runDurable(operationsPerSync, recovered) << "\n";
+    }
+    std::cout << "  batches of " << batchSize << "\t\t" << runDurable(0, recovered) << "\n";
+    std::cout << "  recovery " << (recovered ? "matches" : "differs") << std::endl;
+}
+
+// Run the same operations through the per-call methods and through processBatch on two identical banks
+// and print the time each path took. 60% deposits, 20% withdrawals and 20% transfers over 10,000 accounts;
+// operations are generated in chunks so only one chunk is held in memory at a time.
+void runBatchBenchmark(std::size_t operationCount) {
+    const std::size_t accountCount = 10000;
+    const std::size_t chunkSize = 100000;
+
+    auto runPath = [&](bool batched, Money& total) {
+        BankSystem bank;
+        std::vector<std::unique_ptr<SavingsAccount>> accounts;
+        for (std::size_t i = 0; i < accountCount; ++i) {
+            accounts.emplace_back(new SavingsAccount("BEN" + std::to_string(i), Money::fromDouble(1000000.0)));
+            bank.addAccount(accounts.back().get());
+        }
+
+        std::uint32_t seed = 2024;
+        auto nextRandom = [&seed] { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+        std::vector<BankOperation> chunk;
+        std::chrono::duration<double> elapsed(0);
+
+        for (std::size_t done = 0; done < operationCount; done += chunk.size()) {
+            chunk.clear();
+            for (std::size_t i = 0; i < chunkSize && done + i < operationCount; ++i) {
+                std::uint32_t kind = nextRandom() % 10;
+                TransactionType type = kind < 6 ? TransactionType::Deposit : kind < 8 ? TransactionType::Withdrawal : TransactionType::Transfer;
+                std::string from = accounts[nextRandom() % accountCount]->getAccountNumber();
+                std::string to = type == TransactionType::Transfer ? accounts[nextRandom() % accountCount]->getAccountNumber() : "";
+                chunk.push_back(BankOperation{ type, from, to, Money::fromCents(100), "2024-10-04" });
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            if (batched) {
+                bank.processBatch(chunk);
+            }
+            else {
+                for (const BankOperation& operation : chunk) {
+                    switch (operation.type) {
+                    case TransactionType::Deposit:
+                        bank.processDeposit(operation.accountNumber, operation.amount, operation.date);
+                        break;
+                    case TransactionType::Withdrawal:
+                        bank.processWithdrawal(operation.accountNumber, operation.amount, operation.date);
+                        break;
+                    case TransactionType::Transfer:
+                        bank.processTransfer(operation.accountNumber, operation.toAccountNumber, operation.amount, operation.date);
+                        break;
+                    default:
+                        break;
+                    }
+                }
+            }
+            elapsed += std::chrono::steady_clock::now() - start;
+        }
+        total = bank.getTotalBalance();
+        return elapsed.count();
+    };
+
+    Money perCallTotal, batchedTotal;
+    double perCallSeconds = runPath(false, perCallTotal);
+    double batchedSeconds = runPath(true, batchedTotal);
+    std::cout << "\nBenchmark, " << operationCount << " operations: per-call " << perCallSeconds << " s, batched "
+        << batchedSeconds << " s (" << perCallSeconds / batchedSeconds << "x), total balance "
+        << (perCallTotal == batchedTotal ? "matches" : "differs") << std::endl;
+}
+
+#ifdef _DEBUG
+// Debug builds run these checks with --self-test
+bool checkSelfTest(bool condition, const std::string& description) {
+    std::cout << (condition ? "[PASS] " : "[FAIL] ") << description << std::endl;
+    return condition;
+}
+
+// Everything the statement prints for one account in October 2024
+std::string statementText(const BankSystem& bank, const std::string& accountNumber) {
+    std::ostringstream captured;
+    std::streambuf* previous = std::cout.rdbuf(captured.rdbuf());
+    bank.printStatement(accountNumber, "2024-10-01", "2024-10-31");
+    std::cout.rdbuf(previous);
+    return captured.str();
+}
+
+bool testTransferAppearsOnBothStatements() {
+    // Each side of a transfer sees its own record with its own balance, whether applied per call or in a batch
+    BankSystem bank;
+    SavingsAccount sender("ACC1", Money::fromDouble(500.0));
+    SavingsAccount beneficiary("ACC2", Money::fromDouble(300.0));
+    bank.addAccount(&sender);
+    bank.addAccount(&beneficiary);
+    bank.processTransfer("ACC1", "ACC2", Money::fromDouble(200.0), "2024-10-01");
+    bank.processBatch({ { TransactionType::Transfer, "ACC2", "ACC1", Money::fromDouble(50.0), "2024-10-02" } });
+
+    std::string senderStatement = statementText(bank, "ACC1");
+    std::string beneficiaryStatement = statementText(bank, "ACC2");
+    return checkSelfTest(senderStatement ==
+        "Transaction ID: TXN1, Type: Transfer, Amount: 200.00, Status: Completed, Date: 2024-10-01, Balance After: 300.00\n"
+        "Transaction ID: TXN4, Type: Transfer In, Amount: 50.00, Status: Completed, Date: 2024-10-02, Balance After: 350.00\n"
+        && beneficiaryStatement ==
+        "Transaction ID: TXN2, Type: Transfer In, Amount: 200.00, Status: Completed, Date: 2024-10-01, Balance After: 500.00\n"
+        "Transaction ID: TXN3, Type: Transfer, Amount: 50.00, Status: Completed, Date: 2024-10-02, Balance After: 450.00\n",
+        "transfers show on the beneficiary's statement with the beneficiary's balance");
+}
+
+bool testShardedRefundIsRecorded() {
+    // A cross-shard transfer to an account that does not exist is refunded, and the refund is in the ledger
+    ShardedBankSystem sharded(2);
+    SavingsAccount sender("ACC1", Money::fromDouble(100.0));
+    sharded.addAccount(&sender);
+    std::string missing = "MISSING";
+    for (int i = 0; sharded.shardOf(missing) == sharded.shardOf("ACC1"); ++i) missing = "MISSING" + std::to_string(i);
+    sharded.processTransfer("ACC1", missing, Money::fromDouble(10.0), "2024-10-01");
+
+    std::ostringstream captured;
+    std::streambuf* previous = std::cout.rdbuf(captured.rdbuf());
+    sharded.getTransactionHistory();
+    std::cout.rdbuf(previous);
+    std::string history = captured.str();
+
+    BatchResult result = sharded.getResult();
+    return checkSelfTest(result.applied == 0 && result.failed == 1 && sender.getBalance() == Money::fromDouble(100.0)
+        && history.find("Type: Transfer, Amount: 10.00, Status: Failed, Date: 2024-10-01, Balance After: 90.00\n") != std::string::npos
+        && history.find("Type: Refund, Amount: 10.00, Status: Completed, Date: 2024-10-01, Balance After: 100.00\n") != std::string::npos,
+        "a refunded cross-shard transfer is recorded as failed and refunded");
+}
+
+bool testGroupCommitRecoversAccountsWithKind() {
+    // Operations synced in groups are all recovered after commit(), accounts keep their kind through a snapshot
+    // and the journal, and an account number too long for the journal is rejected before anything is written
+    const std::filesystem::path directory = std::filesystem::temp_directory_path();
+    const std::string journalPath = (directory / "bank_selftest.journal").string();
+    const std::string snapshotPath = (directory / "bank_selftest.snap").string();
+    std::filesystem::remove(journalPath);
+    std::filesystem::remove(snapshotPath);
+
+    Money totalBeforeCrash;
+    bool rejectedLongNumber = false;
+    {
+        BankSystem bank;
+        bank.openDurableStore(journalPath, snapshotPath, 4, 16);
+        SavingsAccount first("ACC1", Money::fromDouble(100.0));
+        SavingsAccount second("ACC2", Money::fromDouble(100.0));
+        SavingsAccount tooLong(std::string(BankSystem::maxAccountNumberLength + 1, '9'), Money::fromDouble(100.0));
+        bank.addAccount(&first);
+        try {
+            bank.addAccount(&tooLong);
+        }
+        catch (const std::invalid_argument&) {
+            rejectedLongNumber = true;
+        }
+        for (int i = 0; i < 5; ++i) bank.processDeposit("ACC1", Money::fromDouble(1.0), "2024-10-01");
+        bank.addAccount(&second);
+        for (int i = 0; i < 5; ++i) bank.processTransfer("ACC1", "ACC2", Money::fromDouble(2.0), "2024-10-02");
+        bank.commit();
+        totalBeforeCrash = bank.getTotalBalance();
+    }
+
+    BankSnapshot snapshot;
+    bool snapshotHasKinds = snapshot.load(snapshotPath) && !snapshot.accounts.empty()
+        && std::all_of(snapshot.accounts.begin(), snapshot.accounts.end(),
+            [](const BankSnapshot::AccountState& account) { return account.kind == AccountKind::Savings; });
+    BankSystem recoveredBank;
+    RecoveryResult recovery = recoveredBank.openDurableStore(journalPath, snapshotPath, 4);
+    std::filesystem::remove(journalPath);
+    std::filesystem::remove(snapshotPath);
+
+    return checkSelfTest(rejectedLongNumber && snapshotHasKinds && recovery.fromSnapshot && recovery.accountsRestored == 2
+        && recoveredBank.getTotalBalance() == totalBeforeCrash && totalBeforeCrash == Money::fromDouble(205.0),
+        "group-committed operations and account kinds survive recovery; oversized account numbers are rejected");
+}
+
+int runSelfTests() {
+    bool passed = true;
+    passed &= testTransferAppearsOnBothStatements();
+    passed &= testShardedRefundIsRecorded();
+    passed &= testGroupCommitRecoversAccountsWithKind();
+
+    std::cout << (passed ? "\nAll self tests passed.\n" : "\nSome self tests failed.\n");
+    return passed ? 0 : 1;
+}
+#endif
+
 // Example usage
-int main() {
+int main(int argc, char* argv[]) {
+#ifdef _DEBUG
+    if (argc > 1 && std::string(argv[1]) == "--self-test") return runSelfTests();
+#endif
+
     try {
+        // Compare the ledger with the old per-object layout (2M transactions), logging off and on (1M deposits),
+        // sharded throughput by shard count (1M transfers), durable throughput by sync interval (20,000 transfers),
+        // then the batched and per-call paths:
+        // run with --benchmark [operations], 10M by default
+        if (argc > 1 && std::string(argv[1]) == "--benchmark") {
+            runLedgerBenchmark(2000000);
+            runLoggingBenchmark(1000000);
+            runShardBenchmark(1000000);
+            runDurableBenchmark(20000);
+            runBatchBenchmark(argc > 2 ? std::stoull(argv[2]) : 10000000);
+            return 0;
+        }
+
         BankSystem bank;
 
         // Create accounts
-        SavingsAccount* account1 = new SavingsAccount("ACC123", 500.0);
-        SavingsAccount* account2 = new SavingsAccount("ACC456", 300.0);
+        SavingsAccount* account1 = new SavingsAccount("ACC123", Money::fromDouble(500.0));
+        SavingsAccount* account2 = new SavingsAccount("ACC456", Money::fromDouble(300.0));
 
         bank.addAccount(account1);
         bank.addAccount(account2);
 
+        // Log transactions to the console and to a binary file
+        BufferedTextSink consoleSink(std::cout);
+        std::ofstream binaryLog("transactions.bin", std::ios::binary);
+        BinaryTransactionSink binarySink(binaryLog);
+        bank.addSink(&consoleSink);
+        bank.addSink(&binarySink);
+
         // Process transactions
-        bank.processDeposit("ACC123", 100.0, "2024-09-30");
-        bank.processWithdrawal("ACC123", 50.0, "2024-09-30");
-        bank.processTransfer("ACC123", "ACC456", 200.0, "2024-09-30");
+        bank.processDeposit("ACC123", Money::fromDouble(100.0), "2024-09-30");
+        bank.processWithdrawal("ACC123", Money::fromDouble(50.0), "2024-09-30");
+        bank.processTransfer("ACC123", "ACC456", Money::fromDouble(200.0), "2024-09-30");
+        bank.flushSinks();
+
+        // Process a batch of operations in one call
+        std::vector<BankOperation> batch = {
+            { TransactionType::Deposit, "ACC456", "", Money::fromDouble(75.0), "2024-10-01" },
+            { TransactionType::Withdrawal, "ACC123", "", Money::fromDouble(1000.0), "2024-10-01" }, // fails: insufficient funds
+            { TransactionType::Transfer, "ACC456", "ACC123", Money::fromDouble(25.0), "2024-10-01" },
+        };
+        BatchResult result = bank.processBatch(batch);
+        bank.flushSinks();
+        std::cout << "\nBatch processed: " << result.applied << " applied, " << result.failed << " failed\n";
+
+        // Statement for one account and date range
+        std::cout << "\nStatement for ACC456 from 2024-10-01 to 2024-10-31:\n";
+        bank.printStatement("ACC456", "2024-10-01", "2024-10-31");
 
         // Retrieve transaction history
         std::cout << "\nTransaction History:\n";
         bank.getTransactionHistory();
 
+        // Sharded engine: a synthetic workload of transfers, 90% of them between accounts on the same shard
+        {
+            std::size_t shardCount = std::max(2u, std::thread::hardware_concurrency());
+            ShardedBankSystem sharded(shardCount);
+            std::vector<std::unique_ptr<SavingsAccount>> shardedAccounts;
+            std::vector<std::vector<std::string>> accountsByShard(shardCount);
+            for (std::size_t i = 0; i < 1000 * shardCount; ++i) {
+                shardedAccounts.emplace_back(new SavingsAccount("SHD" + std::to_string(i), Money::fromDouble(1000.0)));
+                sharded.addAccount(shardedAccounts.back().get());
+                accountsByShard[sharded.shardOf(shardedAccounts.back()->getAccountNumber())].push_back(shardedAccounts.back()->getAccountNumber());
+            }
+
+            const int operationCount = 200000;
+            std::uint32_t seed = 12345;
+            auto nextRandom = [&seed] { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < operationCount; ++i) {
+                std::size_t fromShard = i % shardCount;
+                std::size_t toShard = nextRandom() % 10 == 0 ? (fromShard + 1 + nextRandom() % (shardCount - 1)) % shardCount : fromShard;
+                const auto& fromList = accountsByShard[fromShard];
+                const auto& toList = accountsByShard[toShard];
+                if (fromList.empty() || toList.empty()) continue;
+                sharded.processTransfer(fromList[nextRandom() % fromList.size()], toList[nextRandom() % toList.size()],
+                    Money::fromDouble(1.0), "2024-10-02");
+            }
+            sharded.waitUntilIdle();
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+            Money total;
+            for (const auto& account : shardedAccounts) total += account->getBalance();
+            BatchResult shardedResult = sharded.getResult();
+            std::cout << "\nSharded engine: " << shardedResult.applied << " applied, " << shardedResult.failed << " failed across "
+                << shardCount << " shards in " << elapsed.count() << " ms, total balance " << total << std::endl;
+        }
+
+        // Durable store: journal every transaction, sync every 64 and snapshot every 1000 entries, then recover after a simulated crash
+        {
+            std::filesystem::remove("bank.journal");
+            std::filesystem::remove("bank.snap");
+            Money totalBeforeCrash;
+            {
+                BankSystem durableBank;
+                durableBank.openDurableStore("bank.journal", "bank.snap", 1000, 64);
+                std::vector<std::unique_ptr<SavingsAccount>> durableAccounts;
+                for (int i = 0; i < 10; ++i) {
+                    durableAccounts.emplace_back(new SavingsAccount("DUR" + std::to_string(i), Money::fromDouble(1000.0)));
+                    durableBank.addAccount(durableAccounts.back().get());
+                }
+                for (int i = 0; i < 25500; ++i) {
+                    durableBank.processTransfer("DUR" + std::to_string(i % 10), "DUR" + std::to_string((i + 3) % 10),
+                        Money::fromDouble(1.0), "2024-10-03");
+                }
+                durableBank.processDeposit("DUR0", Money::fromDouble(42.0), "2024-10-03");
+                durableBank.commit();
+                totalBeforeCrash = durableBank.getTotalBalance();
+            } // no final snapshot: the last 501 entries exist only in the journal
+
+            auto start = std::chrono::steady_clock::now();
+            BankSystem recoveredBank;
+            RecoveryResult recovery = recoveredBank.openDurableStore("bank.journal", "bank.snap", 1000);
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            std::cout << "\nRecovered " << recovery.accountsRestored << " accounts from " << (recovery.fromSnapshot ? "a snapshot" : "the journal")
+                << " and replayed " << recovery.entriesReplayed << " journal entries in " << elapsed.count() << " ms, total balance "
+                << (recoveredBank.getTotalBalance() == totalBeforeCrash ? "matches" : "differs") << std::endl;
+        }
+
         // Clean up
         delete account1;
         delete account2;
@@ -1,5 +1,18 @@
 #include <iostream>
 #include <string>
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <tuple>
+#include <utility>
+#include <stdexcept>
+#include <memory>
+
+#include "../Common/Money.h"
 using namespace std;
 
 // Base class: Account
@@ -7,19 +20,19 @@ class Account {
 protected:
     string accountNumber;
     string accountHolderName;
-    double balance;
+    Money balance;
 
 public:
     // Constructor
-    Account(string accNum, string holderName, double initBalance) {
+    Account(string accNum, string holderName, Money initBalance) {
         accountNumber = accNum;
         accountHolderName = holderName;
         balance = initBalance;
     }
 
     // Method to deposit money
-    virtual void deposit(double amount) {
-        if (amount > 0) {
+    virtual void deposit(Money amount) {
+        if (amount.isPositive()) {
             balance += amount;
             cout << "Deposited $" << amount << " to account " << accountNumber << endl;
         }
@@ -29,8 +42,8 @@ public:
     }
 
     // Virtual method to withdraw money (polymorphic)
-    virtual bool withdraw(double amount) {
-        if (amount > 0 && amount <= balance) {
+    virtual bool withdraw(Money amount) {
+        if (amount.isPositive() && amount <= balance) {
             balance -= amount;
             cout << "Withdrawn $" << amount << " from account " << accountNumber << endl;
             return true;
@@ -41,6 +54,19 @@ public:
         }
     }
 
+    const string& getAccountNumber() const {
+        return accountNumber;
+    }
+
+    Money getBalance() const {
+        return balance;
+    }
+
+    // Method to store a balance computed in bulk (see InterestAccrualEngine::writeBack)
+    void setBalance(Money newBalance) {
+        balance = newBalance;
+    }
+
     // Method to check balance
     void checkBalance() const {
         cout << "Balance for account " << accountNumber << ": $" << balance << endl;
@@ -50,20 +76,82 @@ public:
     virtual ~Account() {}
 };
 
+// Overdraft policies: the lowest balance, in cents, a debit may leave behind
+struct NoOverdraft {
+    int64_t floorCents() const { return 0; }
+};
+
+struct LimitedOverdraft {
+    Money limit;
+    int64_t floorCents() const { return -limit.toCents(); }
+};
+
+// Fee policies: the fee, in cents, charged on top of a debit of amountCents from balanceCents.
+// Written without branches so bulk debits stay vectorizable.
+struct NoFee {
+    int64_t feeCents(int64_t, int64_t) const { return 0; }
+};
+
+// Flat fee whenever a debit dips into the overdraft
+struct FlatOverdraftFee {
+    Money fee;
+    int64_t feeCents(int64_t balanceCents, int64_t amountCents) const {
+        return fee.toCents() * static_cast<int64_t>(amountCents > balanceCents);
+    }
+};
+
+// Account whose withdrawal rules are fixed at compile time by its policies.
+// debit() is the silent, non-virtual fast path; withdraw() keeps the virtual interface for mixed collections.
+template <typename OverdraftPolicy, typename FeePolicy>
+class PolicyAccount : public Account {
+protected:
+    OverdraftPolicy overdraftPolicy;
+    FeePolicy feePolicy;
+
+public:
+    PolicyAccount(string accNum, string holderName, Money initBalance,
+        OverdraftPolicy overdraft = OverdraftPolicy(), FeePolicy fee = FeePolicy())
+        : Account(accNum, holderName, initBalance), overdraftPolicy(overdraft), feePolicy(fee) {}
+
+    // The debit rule shared by debit() and AccountGroup::debitAll: returns the balance after debiting amountCents,
+    // or balanceCents unchanged when the amount is not positive or would pass the overdraft floor.
+    // allowed receives 1 or 0. Branch-free so bulk debits stay vectorizable.
+    static int64_t applyDebit(const OverdraftPolicy& overdraft, const FeePolicy& fee, int64_t balanceCents,
+        int64_t amountCents, int64_t& allowed) {
+        allowed = static_cast<int64_t>(amountCents > 0) & static_cast<int64_t>(balanceCents - amountCents >= overdraft.floorCents());
+        int64_t debited = balanceCents - amountCents - fee.feeCents(balanceCents, amountCents);
+        return allowed ? debited : balanceCents;
+    }
+
+    bool debit(Money amount) {
+        int64_t allowed;
+        balance = Money::fromCents(applyDebit(overdraftPolicy, feePolicy, balance.toCents(), amount.toCents(), allowed));
+        return allowed != 0;
+    }
+
+    bool withdraw(Money amount) override {
+        if (debit(amount)) {
+            cout << "Withdrawn $" << amount << " from account " << accountNumber << endl;
+            return true;
+        }
+        cout << "Insufficient balance for withdrawal." << endl;
+        return false;
+    }
+};
+
 // Derived class: SavingsAccount
-class SavingsAccount : public Account {
+class SavingsAccount : public PolicyAccount<NoOverdraft, NoFee> {
 private:
-    double interestRate;
+    int64_t interestRateBasisPoints; // 1% = 100 basis points
 
 public:
     // Constructor
-    SavingsAccount(string accNum, string holderName, double initBalance, double rate)
-        : Account(accNum, holderName, initBalance), interestRate(rate) {}
+    SavingsAccount(string accNum, string holderName, Money initBalance, double rate)
+        : PolicyAccount(accNum, holderName, initBalance), interestRateBasisPoints(llround(rate * 100)) {}
 
     // Override the withdraw method (Savings cannot go negative)
-    bool withdraw(double amount) override {
-        if (amount > 0 && amount <= balance) {
-            balance -= amount;
+    bool withdraw(Money amount) override {
+        if (debit(amount)) {
             cout << "Withdrawn $" << amount << " from Savings account " << accountNumber << endl;
             return true;
         }
@@ -73,38 +161,39 @@ public:
         }
     }
 
+    int64_t getInterestRateBasisPoints() const {
+        return interestRateBasisPoints;
+    }
+
     // Method to add interest (for simplicity, just call it when needed)
     void addInterest() {
-        double interest = balance * interestRate / 100;
+        Money interest = balance.applyRate(interestRateBasisPoints, RoundingMode::HalfEven);
         balance += interest;
         cout << "Added $" << interest << " interest to Savings account " << accountNumber << endl;
     }
 };
 
 // Derived class: CheckingAccount
-class CheckingAccount : public Account {
-private:
-    double overdraftLimit;
-    double overdraftFee;
-
+class CheckingAccount : public PolicyAccount<LimitedOverdraft, FlatOverdraftFee> {
 public:
     // Constructor
-    CheckingAccount(string accNum, string holderName, double initBalance, double overdraftLimit, double overdraftFee)
-        : Account(accNum, holderName, initBalance), overdraftLimit(overdraftLimit), overdraftFee(overdraftFee) {}
+    CheckingAccount(string accNum, string holderName, Money initBalance, Money overdraftLimit, Money overdraftFee)
+        : PolicyAccount(accNum, holderName, initBalance, LimitedOverdraft{ overdraftLimit }, FlatOverdraftFee{ overdraftFee }) {}
+
+    Money getOverdraftLimit() const { return overdraftPolicy.limit; }
+    Money getOverdraftFee() const { return feePolicy.fee; }
 
     // Override the withdraw method (Checking account can go negative with a fee)
-    bool withdraw(double amount) override {
-        if (amount > 0 && amount <= balance) {
-            // Withdraw within balance
-            balance -= amount;
-            cout << "Withdrawn $" << amount << " from Checking account " << accountNumber << endl;
-            return true;
-        }
-        else if (amount > 0 && balance - amount >= -overdraftLimit) {
-            // Withdraw within overdraft limit
-            balance -= (amount + overdraftFee);
-            cout << "Withdrawn $" << amount << " with overdraft fee $" << overdraftFee << " from Checking account "
-                << accountNumber << endl;
+    bool withdraw(Money amount) override {
+        bool withinBalance = amount <= balance;
+        if (debit(amount)) {
+            if (withinBalance) {
+                cout << "Withdrawn $" << amount << " from Checking account " << accountNumber << endl;
+            }
+            else {
+                cout << "Withdrawn $" << amount << " with overdraft fee $" << feePolicy.fee << " from Checking account "
+                    << accountNumber << endl;
+            }
             return true;
         }
         else {
@@ -114,26 +203,488 @@ public:
     }
 };
 
-// Main function to demonstrate the bank account system
-int main() {
+// Accounts of one policy type stored column-wise: every account in the group shares the same product terms,
+// so bulk operations call the policies directly over a plain array of balances.
+// An account added by reference must have the group's product terms and is linked to its entry: while it is in
+// the group the group's balance is the current one, and writeBack() stores it in the account object.
+template <typename OverdraftPolicy, typename FeePolicy>
+class AccountGroup {
+private:
+    using Rule = PolicyAccount<OverdraftPolicy, FeePolicy>;
+
+    vector<string> accountNumbers;
+    vector<int64_t> balanceCents;
+    vector<pair<size_t, Rule*>> linkedAccounts; // group index and the account it was loaded from
+    OverdraftPolicy overdraftPolicy;
+    FeePolicy feePolicy;
+
+public:
+    explicit AccountGroup(OverdraftPolicy overdraft = OverdraftPolicy(), FeePolicy fee = FeePolicy())
+        : overdraftPolicy(overdraft), feePolicy(fee) {}
+
+    size_t addAccount(const string& accountNumber, Money balance) {
+        accountNumbers.push_back(accountNumber);
+        balanceCents.push_back(balance.toCents());
+        return balanceCents.size() - 1;
+    }
+
+    size_t addAccount(Rule& account) {
+        size_t index = addAccount(account.getAccountNumber(), account.getBalance());
+        linkedAccounts.emplace_back(index, &account);
+        return index;
+    }
+
+    size_t size() const { return balanceCents.size(); }
+    const string& getAccountNumber(size_t index) const { return accountNumbers[index]; }
+    Money getBalance(size_t index) const { return Money::fromCents(balanceCents[index]); }
+
+    // Store the group's balances in every account added by reference; returns how many were updated
+    size_t writeBack() {
+        for (const auto& linked : linkedAccounts) {
+            linked.second->setBalance(getBalance(linked.first));
+        }
+        return linkedAccounts.size();
+    }
+
+    // Debit the same amount from every account that can cover it, with the rule of PolicyAccount::debit.
+    // Returns the number of accounts debited.
+    size_t debitAll(Money amount) {
+        const int64_t amountCents = amount.toCents();
+        int64_t* balances = balanceCents.data();
+        size_t applied = 0;
+        for (size_t i = 0; i < balanceCents.size(); ++i) {
+            int64_t allowed;
+            balances[i] = Rule::applyDebit(overdraftPolicy, feePolicy, balances[i], amountCents, allowed);
+            applied += static_cast<size_t>(allowed);
+        }
+        return applied;
+    }
+};
+
+using SavingsGroup = AccountGroup<NoOverdraft, NoFee>;
+using CheckingGroup = AccountGroup<LimitedOverdraft, FlatOverdraftFee>;
+
+// Type-partitioned container: one AccountGroup per account type, kept apart so each is processed
+// by its own specialized loop instead of one virtual call per account.
+template <typename... Groups>
+class PartitionedAccounts {
+private:
+    tuple<Groups...> groups;
+
+public:
+    explicit PartitionedAccounts(Groups... initialGroups) : groups(initialGroups...) {}
+
+    template <typename Group>
+    Group& group() { return get<Group>(groups); }
+
+    // Debit every account of every group; returns the number of accounts debited
+    size_t debitAll(Money amount) {
+        size_t applied = 0;
+        int expand[] = { 0, (applied += get<Groups>(groups).debitAll(amount), 0)... };
+        (void)expand;
+        return applied;
+    }
+
+    // Store every group's balances in its linked accounts; returns how many were updated
+    size_t writeBack() {
+        size_t updated = 0;
+        int expand[] = { 0, (updated += get<Groups>(groups).writeBack(), 0)... };
+        (void)expand;
+        return updated;
+    }
+};
+
+// Nightly interest accrual for many savings accounts at once.
+// Balances (in cents) and rates (in basis points) are kept in parallel arrays instead of one object per account,
+// so the kernel walks plain contiguous arrays. Interest is rounded half-even to whole cents,
+// exactly like SavingsAccount::addInterest.
+// The arrays hold whole numbers of cents as doubles: x86 has no vector 64-bit integer division (or, before
+// AVX-512, int64/double conversion), while double division vectorizes everywhere. Every value is an integer
+// below 2^53, so each step is exact; accrue() checks that bound before it runs.
+class InterestAccrualEngine {
+private:
+    static const size_t chunkSize = 1 << 16; // accounts per unit of work handed to a thread
+
+    vector<double> balanceCents;
+    vector<double> rateBasisPoints;
+    vector<pair<size_t, SavingsAccount*>> linkedAccounts; // engine index and the account it was loaded from
+    double largestBalance = 0; // upper bound on |balance| in cents, see checkExactRange
+    double largestRate = 0;    // largest |rate| in basis points
+
+    // Add interest to balances[0, count) and return the total added.
+    // Rounding to a whole number uses (x + 1.5 * 2^52) - 1.5 * 2^52, which rounds half-even for |x| < 2^51,
+    // instead of comparisons, so the loop has no branches or selects and vectorizes:
+    // g++ -O3 -fopt-info-vec reports "loop vectorized using 16 byte vectors" (32 with -mavx2).
+    // The quotient rounded to nearest leaves a remainder within one denominator; rounding remainder / denominator
+    // then adds the missing step when the remainder is past half, and nothing on an exact half,
+    // because an exact half always came out of the first rounding as an even quotient.
+    static double accrueChunk(double* balances, const double* rates, size_t count) {
+        const double denominator = 10000;
+        const double roundingConstant = 6755399441055744.0; // 1.5 * 2^52
+        double total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            double numerator = balances[i] * rates[i];
+            double quotient = (numerator / denominator + roundingConstant) - roundingConstant;
+            double remainder = numerator - quotient * denominator;
+            double interest = quotient + ((remainder / denominator + roundingConstant) - roundingConstant);
+
+            balances[i] += interest;
+            total += interest;
+        }
+        return total;
+    }
+
+    // Interest is exact while every |balance * rate| is below 2^53. The stored bound only grows, so the
+    // balances are rescanned for their real maximum only when the bound gets too close.
+    void checkExactRange() {
+        const double limit = 4503599627370496.0; // 2^52, half the exact range to leave room for rounding of the bound
+        if (largestBalance * largestRate < limit) return;
+        largestBalance = 0;
+        for (double balance : balanceCents) largestBalance = max(largestBalance, fabs(balance));
+        if (largestBalance * largestRate >= limit) {
+            throw overflow_error("Balance too large for exact interest accrual");
+        }
+    }
+
+public:
+    void reserve(size_t accountCount) {
+        balanceCents.reserve(accountCount);
+        rateBasisPoints.reserve(accountCount);
+    }
+
+    // Returns the index of the account inside the engine
+    size_t addAccount(Money balance, int64_t interestRateBasisPoints) {
+        balanceCents.push_back(static_cast<double>(balance.toCents()));
+        rateBasisPoints.push_back(static_cast<double>(interestRateBasisPoints));
+        largestBalance = max(largestBalance, fabs(balanceCents.back()));
+        largestRate = max(largestRate, fabs(rateBasisPoints.back()));
+        return balanceCents.size() - 1;
+    }
+
+    // The account is linked to its engine entry, so writeBack() can store the accrued balance in it
+    size_t addAccount(SavingsAccount& account) {
+        size_t index = addAccount(account.getBalance(), account.getInterestRateBasisPoints());
+        linkedAccounts.emplace_back(index, &account);
+        return index;
+    }
+
+    size_t size() const {
+        return balanceCents.size();
+    }
+
+    Money getBalance(size_t index) const {
+        return Money::fromCents(static_cast<int64_t>(balanceCents[index]));
+    }
+
+    // Store the engine's balances in every SavingsAccount added by reference; returns how many were updated
+    size_t writeBack() {
+        for (const auto& linked : linkedAccounts) {
+            linked.second->setBalance(getBalance(linked.first));
+        }
+        return linkedAccounts.size();
+    }
+
+    // Accrue one period of interest on every account, spreading chunks of accounts over worker threads.
+    // Returns the total interest paid out.
+    Money accrue(unsigned threadCount = thread::hardware_concurrency()) {
+        checkExactRange();
+        size_t chunkCount = (balanceCents.size() + chunkSize - 1) / chunkSize;
+        if (threadCount == 0) threadCount = 1;
+        if (threadCount > chunkCount) threadCount = static_cast<unsigned>(max<size_t>(chunkCount, 1));
+
+        atomic<size_t> nextChunk(0);
+        vector<int64_t> threadTotals(threadCount, 0);
+        auto worker = [&](unsigned threadIndex) {
+            int64_t total = 0;
+            for (size_t chunk = nextChunk++; chunk < chunkCount; chunk = nextChunk++) {
+                size_t first = chunk * chunkSize;
+                size_t count = min(chunkSize, balanceCents.size() - first);
+                total += static_cast<int64_t>(accrueChunk(balanceCents.data() + first, rateBasisPoints.data() + first, count));
+            }
+            threadTotals[threadIndex] = total;
+        };
+
+        vector<thread> workers;
+        for (unsigned i = 1; i < threadCount; ++i) {
+            workers.emplace_back(worker, i);
+        }
+        worker(0);
+        for (auto& t : workers) t.join();
+
+        // Interest is at most rate / 10000 of the balance, plus the half cent rounded up
+        largestBalance += largestBalance * largestRate / 10000 + 1;
+
+        int64_t total = 0;
+        for (int64_t threadTotal : threadTotals) total += threadTotal;
+        return Money::fromCents(total);
+    }
+};
+
+// Read-only overdraft risk analytics for checking accounts.
+// Keeps its own copy of balances, limits and fees in parallel arrays and never touches the Account objects,
+// so a scan is a pass over contiguous memory split across threads: a branch-free count, then indices for chunks with matches.
+class OverdraftRiskScanner {
+private:
+    static const size_t chunkSize = 1 << 16; // accounts per unit of work handed to a thread
+
+    vector<string> accountNumbers;
+    vector<int64_t> balanceCents;
+    vector<int64_t> limitCents;
+    vector<int64_t> feeCents;
+
+public:
+    struct ScanResult {
+        vector<size_t> nearLimit; // indices of accounts within the threshold of their overdraft limit, ascending
+        Money feeExposure;        // overdraft fees those accounts would pay on their next overdrawn withdrawal
+    };
+
+    void reserve(size_t accountCount) {
+        accountNumbers.reserve(accountCount);
+        balanceCents.reserve(accountCount);
+        limitCents.reserve(accountCount);
+        feeCents.reserve(accountCount);
+    }
+
+    size_t addAccount(const string& accountNumber, Money balance, Money overdraftLimit, Money overdraftFee) {
+        accountNumbers.push_back(accountNumber);
+        balanceCents.push_back(balance.toCents());
+        limitCents.push_back(overdraftLimit.toCents());
+        feeCents.push_back(overdraftFee.toCents());
+        return balanceCents.size() - 1;
+    }
+
+    size_t addAccount(const CheckingAccount& account) {
+        return addAccount(account.getAccountNumber(), account.getBalance(), account.getOverdraftLimit(), account.getOverdraftFee());
+    }
+
+    size_t size() const { return balanceCents.size(); }
+    const string& getAccountNumber(size_t index) const { return accountNumbers[index]; }
+
+    // Find accounts whose remaining headroom (balance + overdraft limit) is at most threshold
+    ScanResult scan(Money threshold, unsigned threadCount = thread::hardware_concurrency()) const {
+        const size_t accountCount = balanceCents.size();
+        const size_t chunkCount = (accountCount + chunkSize - 1) / chunkSize;
+        if (threadCount == 0) threadCount = 1;
+        if (threadCount > chunkCount) threadCount = static_cast<unsigned>(max<size_t>(chunkCount, 1));
+
+        // Each chunk keeps its own match list, so threads never share output
+        vector<vector<size_t>> chunkMatches(chunkCount);
+        vector<int64_t> chunkFees(chunkCount, 0);
+        const int64_t thresholdCents = threshold.toCents();
+        atomic<size_t> nextChunk(0);
+
+        auto worker = [&]() {
+            for (size_t chunk = nextChunk++; chunk < chunkCount; chunk = nextChunk++) {
+                const size_t first = chunk * chunkSize;
+                const size_t last = min(first + chunkSize, accountCount);
+
+                // Count and fee pass: a plain reduction with no stores, so it vectorizes (64-bit compares need SSE4.2)
+                size_t found = 0;
+                int64_t fees = 0;
+                for (size_t i = first; i < last; ++i) {
+                    int64_t atRisk = balanceCents[i] + limitCents[i] <= thresholdCents;
+                    found += static_cast<size_t>(atRisk);
+                    fees += feeCents[i] * atRisk;
+                }
+                chunkFees[chunk] = fees;
+                if (found == 0) continue;
+
+                // Index pass, only for chunks with matches, into a list sized by the count
+                vector<size_t>& matches = chunkMatches[chunk];
+                matches.reserve(found);
+                for (size_t i = first; i < last; ++i) {
+                    if (balanceCents[i] + limitCents[i] <= thresholdCents) matches.push_back(i);
+                }
+            }
+        };
+
+        vector<thread> workers;
+        for (unsigned i = 1; i < threadCount; ++i) {
+            workers.emplace_back(worker);
+        }
+        worker();
+        for (auto& t : workers) t.join();
+
+        ScanResult result;
+        size_t totalFound = 0;
+        for (const auto& matches : chunkMatches) totalFound += matches.size();
+        result.nearLimit.reserve(totalFound);
+
+        int64_t exposure = 0;
+        for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+            result.nearLimit.insert(result.nearLimit.end(), chunkMatches[chunk].begin(), chunkMatches[chunk].end());
+            exposure += chunkFees[chunk];
+        }
+        result.feeExposure = Money::fromCents(exposure);
+        return result;
+    }
+};
+
+// Debit throughput over accountCount accounts, half savings and half checking, through three layouts:
+// one heap object per account debited through a virtual call (the layout before the policies), the policy
+// accounts debited one by one through the non-virtual debit(), and the partitioned groups' bulk debitAll.
+// Every path applies the same rule, so each reports the same number of debits.
+void runDebitBenchmark(size_t accountCount, int rounds) {
+    struct VirtualDebitAccount {
+        virtual ~VirtualDebitAccount() {}
+        virtual bool debit(int64_t amountCents) = 0;
+    };
+    struct VirtualSavings : VirtualDebitAccount {
+        int64_t balanceCents;
+        explicit VirtualSavings(int64_t balance) : balanceCents(balance) {}
+        bool debit(int64_t amountCents) override {
+            int64_t allowed;
+            balanceCents = PolicyAccount<NoOverdraft, NoFee>::applyDebit(NoOverdraft(), NoFee(), balanceCents, amountCents, allowed);
+            return allowed != 0;
+        }
+    };
+    struct VirtualChecking : VirtualDebitAccount {
+        int64_t balanceCents;
+        LimitedOverdraft overdraft;
+        FlatOverdraftFee fee;
+        VirtualChecking(int64_t balance, LimitedOverdraft limit, FlatOverdraftFee overdraftFee)
+            : balanceCents(balance), overdraft(limit), fee(overdraftFee) {}
+        bool debit(int64_t amountCents) override {
+            int64_t allowed;
+            balanceCents = PolicyAccount<LimitedOverdraft, FlatOverdraftFee>::applyDebit(overdraft, fee, balanceCents, amountCents, allowed);
+            return allowed != 0;
+        }
+    };
+
+    const LimitedOverdraft limit{ Money::fromDouble(200.0) };
+    const FlatOverdraftFee fee{ Money::fromDouble(35.0) };
+    const Money amount = Money::fromDouble(10.0);
+    vector<unique_ptr<VirtualDebitAccount>> virtualAccounts;
+    vector<SavingsAccount> savingsAccounts;
+    vector<CheckingAccount> checkingAccounts;
+    PartitionedAccounts<SavingsGroup, CheckingGroup> book(SavingsGroup(), CheckingGroup(limit, fee));
+    virtualAccounts.reserve(accountCount);
+    savingsAccounts.reserve(accountCount / 2 + 1);
+    checkingAccounts.reserve(accountCount / 2 + 1);
+    for (size_t i = 0; i < accountCount; ++i) {
+        Money balance = Money::fromCents(static_cast<int64_t>(i * 7919 % 20000));
+        string accountNumber = to_string(i);
+        if (i % 2 == 0) {
+            virtualAccounts.emplace_back(new VirtualSavings(balance.toCents()));
+            savingsAccounts.emplace_back(accountNumber, "Benchmark", balance, 2.0);
+            book.group<SavingsGroup>().addAccount(accountNumber, balance);
+        }
+        else {
+            virtualAccounts.emplace_back(new VirtualChecking(balance.toCents(), limit, fee));
+            checkingAccounts.emplace_back(accountNumber, "Benchmark", balance, limit.limit, fee.fee);
+            book.group<CheckingGroup>().addAccount(accountNumber, balance);
+        }
+    }
+
+    auto time = [accountCount, rounds](const char* path, auto debitAll) {
+        size_t applied = 0;
+        auto start = chrono::steady_clock::now();
+        for (int round = 0; round < rounds; ++round) applied += debitAll();
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        cout << "  " << path << elapsed.count() * 1e9 / (static_cast<double>(accountCount) * rounds) << " ns/account, "
+            << applied << " debits" << endl;
+    };
+
+    cout << "Debiting " << accountCount << " accounts " << rounds << " times:" << endl;
+    time("virtual call per account    ", [&] {
+        size_t applied = 0;
+        for (auto& account : virtualAccounts) applied += account->debit(amount.toCents());
+        return applied;
+    });
+    time("policy debit() per account  ", [&] {
+        size_t applied = 0;
+        for (auto& account : savingsAccounts) applied += account.debit(amount);
+        for (auto& account : checkingAccounts) applied += account.debit(amount);
+        return applied;
+    });
+    time("AccountGroup::debitAll      ", [&] { return book.debitAll(amount); });
+}
+
+// Main function to demonstrate the bank account system; run with --benchmark to time the debit paths instead
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--benchmark") {
+        runDebitBenchmark(2000000, 20);
+        return 0;
+    }
+
     // Creating a SavingsAccount
-    SavingsAccount savings("S12345", "John Doe", 1000.0, 2.0); // 2% interest rate
+    SavingsAccount savings("S12345", "John Doe", Money::fromDouble(1000.0), 2.0); // 2% interest rate
     savings.checkBalance();
-    savings.deposit(500.0);
-    savings.withdraw(200.0);
+    savings.deposit(Money::fromDouble(500.0));
+    savings.withdraw(Money::fromDouble(200.0));
     savings.addInterest();
     savings.checkBalance();
 
     cout << endl;
 
     // Creating a CheckingAccount
-    CheckingAccount checking("C67890", "Jane Smith", 500.0, 200.0, 35.0); // $200 overdraft limit, $35 fee
+    CheckingAccount checking("C67890", "Jane Smith", Money::fromDouble(500.0), Money::fromDouble(200.0), Money::fromDouble(35.0)); // $200 overdraft limit, $35 fee
     checking.checkBalance();
-    checking.deposit(300.0);
-    checking.withdraw(700.0); // Within overdraft limit
+    checking.deposit(Money::fromDouble(300.0));
+    checking.withdraw(Money::fromDouble(700.0)); // Within overdraft limit
     checking.checkBalance();
-    checking.withdraw(200.0); // Exceeds overdraft limit
+    checking.withdraw(Money::fromDouble(200.0)); // Exceeds overdraft limit
     checking.checkBalance();
 
+    cout << endl;
+
+    // Bulk debit of a monthly service charge over type-partitioned accounts
+    PartitionedAccounts<SavingsGroup, CheckingGroup> book(SavingsGroup(),
+        CheckingGroup(LimitedOverdraft{ Money::fromDouble(200.0) }, FlatOverdraftFee{ Money::fromDouble(35.0) }));
+    book.group<SavingsGroup>().addAccount("S20001", Money::fromDouble(50.0));
+    book.group<SavingsGroup>().addAccount("S20002", Money::fromDouble(5.0));
+    book.group<CheckingGroup>().addAccount("C30001", Money::fromDouble(5.0));
+    book.group<CheckingGroup>().addAccount("C30002", Money::fromDouble(-198.0));
+    book.group<CheckingGroup>().addAccount(checking);
+    size_t charged = book.debitAll(Money::fromDouble(10.0));
+    cout << "Service charge applied to " << charged << " of 5 accounts" << endl;
+    for (size_t i = 0; i < book.group<CheckingGroup>().size(); ++i) {
+        cout << "Balance for account " << book.group<CheckingGroup>().getAccountNumber(i) << ": $"
+            << book.group<CheckingGroup>().getBalance(i) << endl;
+    }
+    book.writeBack();
+    checking.checkBalance();
+
+    cout << endl;
+
+    // Nightly interest run over a large book of savings accounts
+    const size_t accountCount = 1000000;
+    InterestAccrualEngine engine;
+    engine.reserve(accountCount + 1);
+    engine.addAccount(savings);
+    for (size_t i = 0; i < accountCount; ++i) {
+        engine.addAccount(Money::fromCents(static_cast<int64_t>(i % 5000000) + 1), 50 + static_cast<int64_t>(i % 400));
+    }
+
+    auto start = chrono::steady_clock::now();
+    Money totalInterest = engine.accrue();
+    chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+
+    cout << "Accrued $" << totalInterest << " interest on " << engine.size() << " savings accounts in "
+        << elapsed.count() << " ms" << endl;
+    engine.writeBack();
+    savings.checkBalance();
+
+    cout << endl;
+
+    // Overdraft risk scan: which checking accounts are within $50 of their overdraft limit
+    OverdraftRiskScanner scanner;
+    scanner.reserve(accountCount + 1);
+    scanner.addAccount(checking);
+    for (size_t i = 0; i < accountCount; ++i) {
+        scanner.addAccount("C" + to_string(40000000 + i), Money::fromCents(static_cast<int64_t>(i % 200000) - 50000),
+            Money::fromDouble(500.0), Money::fromDouble(35.0));
+    }
+
+    start = chrono::steady_clock::now();
+    OverdraftRiskScanner::ScanResult risk = scanner.scan(Money::fromDouble(50.0));
+    elapsed = chrono::steady_clock::now() - start;
+
+    cout << risk.nearLimit.size() << " of " << scanner.size() << " checking accounts are within $50 of their overdraft limit, "
+        << "fee exposure $" << risk.feeExposure << " (scanned in " << elapsed.count() << " ms)" << endl;
+    if (!risk.nearLimit.empty()) {
+        cout << "First account at risk: " << scanner.getAccountNumber(risk.nearLimit.front()) << endl;
+    }
+
     return 0;
 }
@@ -2,11 +2,68 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <string_view>
+#include <cctype>
 #include <vector>
 #include <iomanip>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <filesystem>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <random>
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+#include "../Common/Money.h"
 
 using namespace std;
+
+#ifdef _DEBUG
+//debug builds count heap allocations so the self tests can check that menu actions do not copy the client table.
+atomic <size_t> HeapAllocationsCount{ 0 };
+
+void* operator new(size_t Size)
+{
+    HeapAllocationsCount++;
+    if (void* Block = malloc(Size ? Size : 1))
+        return Block;
+    throw bad_alloc();
+}
+
+void operator delete(void* Block) noexcept
+{
+    free(Block);
+}
+
+void operator delete(void* Block, size_t) noexcept
+{
+    free(Block);
+}
+#endif
+
 const string ClientsFileName = "Clients.txt";
+const string ClientsLogFileName = "Clients.log";
+const string ClientsSnapshotFileName = "Clients.snap";
+
+//Clients.txt is rewritten only when this share of its rows is stale.
+const double CompactionDeadRecordsRatio = 0.25;
 
 void ShowMainMenue();
 
@@ -16,91 +73,434 @@ struct sClient
     string PinCode;
     string Name;
     string Phone;
-    double AccountBalance;
+    Money AccountBalance;
     bool MarkForDelete = false;
+    long long FileOffset = -1; //where the record line starts in Clients.txt, -1 if it lives in the log.
+    size_t LineLength = 0;
+};
+
+struct stClientsIndex
+{
+    vector <sClient> vClients;
+    unordered_map <string, size_t> RecordByAccountNumber; // AccountNumber -> position in vClients
+    atomic <size_t> DeadRecords{ 0 }; //rows in Clients.txt and Clients.log that are no longer current.
+    bool IsLoaded = false;
+};
+
+stClientsIndex ClientsIndex;
+
+//several tellers can work on the index at once: record work holds ClientsIndexLock shared plus
+//the lock of the record's shard, anything that adds or removes index entries holds it exclusive.
+const short ClientLockShardsCount = 64;
+shared_mutex ClientsIndexLock;
+mutex ClientLockShards[ClientLockShardsCount];
+mutex ClientsFilesLock; //one writer at a time for Clients.txt and Clients.log.
+
+//Clients.snap is a binary copy of Clients.txt laid out column by column:
+//header, fixed width account numbers, heap references for pin/name/phone,
+//file offsets, line lengths, balances in cents and finally the string heap.
+const char ClientsSnapshotMagic[8] = { 'C', 'L', 'S', 'N', 'A', 'P', '0', '1' };
+const short SnapshotAccountNumberWidth = 16;
+
+struct stSnapshotHeader
+{
+    char Magic[8];
+    uint64_t SourceFileSize;
+    int64_t SourceWriteTime;
+    uint32_t RecordsCount;
+    uint32_t HeapSize;
 };
 
-vector<string> SplitString(string S1, string Delim)
+struct stHeapString
+{
+    uint32_t Offset;
+    uint32_t Length;
+};
+
+vector<string> SplitString(const string& S1, const string& Delim)
 {
     vector<string> vString;
-    short pos = 0;
-    string sWord; // define a string variable  
+    size_t WordStart = 0;
+    size_t pos = 0;
 
-  
     // use find() function to get the position of the delimiters  
-    while ((pos = S1.find(Delim)) != std::string::npos)
+    while ((pos = S1.find(Delim, WordStart)) != std::string::npos)
     {
-        sWord = S1.substr(0, pos); // store the word   
-        if (sWord != "")
+        if (pos != WordStart)
         {
-            vString.push_back(sWord);
+            vString.push_back(S1.substr(WordStart, pos - WordStart)); // store the word   
         }
 
-        S1.erase(0, pos + Delim.length());  /* erase() until positon and move to next word. */
+        WordStart = pos + Delim.length(); /* move to next word without erasing the string. */
     }
 
-    if (S1 != "")
+    if (WordStart < S1.length())
     {
-        vString.push_back(S1); // it adds last word of the string.
+        vString.push_back(S1.substr(WordStart)); // it adds last word of the string.
     }
 
     return vString;
 
 }
 
-sClient ConvertLinetoRecord(string Line, string Seperator = "#//#")
+bool ParseClientLine(string_view Line, sClient& Client, string_view Seperator = "#//#")
 {
-    sClient Client;
-    vector<string> vClientData;
-    vClientData = SplitString(Line, Seperator);
+    //single pass over the line, fields are views into it until they are assigned to the client.
+    string_view vFields[5];
+    short FieldsCount = 0;
+    size_t FieldStart = 0;
 
-    Client.AccountNumber = vClientData[0];
-    Client.PinCode = vClientData[1];
-    Client.Name = vClientData[2];
-    Client.Phone = vClientData[3];
-    Client.AccountBalance = stod(vClientData[4]);//cast string to double
+    while (FieldsCount < 5)
+    {
+        size_t pos = Line.find(Seperator, FieldStart);
+        if (pos == string_view::npos)
+        {
+            vFields[FieldsCount++] = Line.substr(FieldStart);
+            break;
+        }
+
+        vFields[FieldsCount++] = Line.substr(FieldStart, pos - FieldStart);
+        FieldStart = pos + Seperator.length();
+    }
+
+    if (FieldsCount < 5)
+        return false;
+
+    Client.AccountNumber.assign(vFields[0]);
+    Client.PinCode.assign(vFields[1]);
+    Client.Name.assign(vFields[2]);
+    Client.Phone.assign(vFields[3]);
+
+    return Money::parse(vFields[4], Client.AccountBalance);
+}
+
+sClient ConvertLinetoRecord(string_view Line, string_view Seperator = "#//#")
+{
+    sClient Client;
+    ParseClientLine(Line, Client, Seperator);
     return Client;
 }
 
-string ConvertRecordToLine(sClient Client, string Seperator = "#//#")
+size_t AppendRecordToLine(string& stLine, const sClient& Client, const string& Seperator = "#//#")
+{
+    //formats the record at the end of stLine and returns its length, so whole files are built in one buffer.
+    size_t RecordStart = stLine.length();
+    stLine.append(Client.AccountNumber).append(Seperator);
+    stLine.append(Client.PinCode).append(Seperator);
+    stLine.append(Client.Name).append(Seperator);
+    stLine.append(Client.Phone).append(Seperator);
+    stLine += Client.AccountBalance.toString();
+    return stLine.length() - RecordStart;
+}
+
+string ConvertRecordToLine(const sClient& Client, const string& Seperator = "#//#")
 {
 
     string stClientRecord = "";
-    stClientRecord += Client.AccountNumber + Seperator;
-    stClientRecord += Client.PinCode + Seperator;
-    stClientRecord += Client.Name + Seperator;
-    stClientRecord += Client.Phone + Seperator;
-    stClientRecord += to_string(Client.AccountBalance);
+    stClientRecord.reserve(Client.AccountNumber.length() + Client.PinCode.length() + Client.Name.length()
+        + Client.Phone.length() + 4 * Seperator.length() + 16);
+    AppendRecordToLine(stClientRecord, Client, Seperator);
     return stClientRecord;
 }
 
-bool ClientExistsByAccountNumber(string AccountNumber, string FileName)
+string ReadFileContent(const string& FileName)
 {
+    fstream MyFile;
+    MyFile.open(FileName, ios::in | ios::binary);//read Mode
+
+    string Content = "";
+    error_code Error;
+    uintmax_t FileSize = filesystem::file_size(FileName, Error); //fails for anything but a regular file.
+
+    if (MyFile.is_open() && !Error && FileSize > 0)
+    {
+        //read the whole file with one call straight into a string of its size, no stream copy in between.
+        Content.resize((size_t)FileSize);
+        MyFile.read(&Content[0], (streamsize)FileSize);
+        Content.resize((size_t)MyFile.gcount());
+    }
+    return Content;
+}
 
+vector <sClient> LoadCleintsDataFromFile(const string& FileName)
+{
     vector <sClient> vClients;
+    string Content = ReadFileContent(FileName);
+    string_view Data = Content;
+    sClient Client;
+
+    size_t LineStart = 0;
+    while (LineStart < Data.length())
+    {
+        size_t LineEnd = Data.find('\n', LineStart);
+        if (LineEnd == string_view::npos)
+            LineEnd = Data.length();
+
+        string_view Line = Data.substr(LineStart, LineEnd - LineStart);
+        if (!Line.empty() && Line.back() == '\r')
+            Line.remove_suffix(1);
+
+        if (!Line.empty() && ParseClientLine(Line, Client))
+        {
+            Client.FileOffset = LineStart;
+            Client.LineLength = Line.length();
+            vClients.push_back(move(Client));
+        }
+
+        LineStart = LineEnd + 1;
+    }
+    return vClients;
+}
+
+bool GetFileStamp(const string& FileName, uint64_t& FileSize, int64_t& WriteTime)
+{
+    error_code Error;
+    FileSize = filesystem::file_size(FileName, Error);
+    if (Error)
+        return false;
+
+    WriteTime = filesystem::last_write_time(FileName, Error).time_since_epoch().count();
+    return !Error;
+}
+
+template <typename T>
+void AppendColumnValue(string& Buffer, const T& Value)
+{
+    Buffer.append(reinterpret_cast<const char*>(&Value), sizeof(T));
+}
+
+template <typename T>
+T ReadColumnValue(const char* Column, size_t Position)
+{
+    T Value;
+    memcpy(&Value, Column + Position * sizeof(T), sizeof(T));
+    return Value;
+}
+
+stHeapString InternString(const string& Text, string& Heap, unordered_map <string, stHeapString>& InternedStrings)
+{
+    auto Interned = InternedStrings.find(Text);
+    if (Interned != InternedStrings.end())
+        return Interned->second;
+
+    stHeapString HeapString{ (uint32_t)Heap.length(), (uint32_t)Text.length() };
+    Heap += Text;
+    InternedStrings[Text] = HeapString;
+    return HeapString;
+}
+
+bool SaveClientsSnapshot(const string& SnapshotFileName, const string& SourceFileName, const vector <sClient>& vClients)
+{
+    stSnapshotHeader Header;
+    memcpy(Header.Magic, ClientsSnapshotMagic, sizeof(Header.Magic));
+    Header.RecordsCount = (uint32_t)vClients.size();
+
+    if (!GetFileStamp(SourceFileName, Header.SourceFileSize, Header.SourceWriteTime))
+        return false;
+
+    string AccountNumbers, HeapStrings, FileOffsets, LineLengths, Balances, Heap;
+    unordered_map <string, stHeapString> InternedStrings;
+
+    for (const sClient& Client : vClients)
+    {
+        if (Client.AccountNumber.length() > SnapshotAccountNumberWidth)
+            return false;
+
+        string AccountNumber = Client.AccountNumber;
+        AccountNumber.resize(SnapshotAccountNumberWidth, '\0');
+        AccountNumbers += AccountNumber;
+
+        AppendColumnValue(HeapStrings, InternString(Client.PinCode, Heap, InternedStrings));
+        AppendColumnValue(HeapStrings, InternString(Client.Name, Heap, InternedStrings));
+        AppendColumnValue(HeapStrings, InternString(Client.Phone, Heap, InternedStrings));
+        AppendColumnValue(FileOffsets, (int64_t)Client.FileOffset);
+        AppendColumnValue(LineLengths, (uint32_t)Client.LineLength);
+        AppendColumnValue(Balances, Client.AccountBalance.toCents());
+    }
+
+    Header.HeapSize = (uint32_t)Heap.length();
+
+    string TempFileName = SnapshotFileName + ".tmp";
     fstream MyFile;
-    MyFile.open(FileName, ios::in);//read Mode
+    MyFile.open(TempFileName, ios::out | ios::binary);//overwrite
 
-    if (MyFile.is_open())
+    if (!MyFile.is_open())
+        return false;
+
+    MyFile.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+    MyFile << AccountNumbers << HeapStrings << FileOffsets << LineLengths << Balances << Heap;
+    MyFile.close();
+
+    error_code Error;
+    filesystem::rename(TempFileName, SnapshotFileName, Error);
+    return !Error;
+}
+
+bool LoadClientsSnapshot(const string& SnapshotFileName, const string& SourceFileName, vector <sClient>& vClients)
+{
+    uint64_t SourceFileSize;
+    int64_t SourceWriteTime;
+
+    if (!GetFileStamp(SourceFileName, SourceFileSize, SourceWriteTime))
+        return false;
+
+    string Content = ReadFileContent(SnapshotFileName);
+    stSnapshotHeader Header;
+
+    if (Content.length() < sizeof(Header))
+        return false;
+
+    memcpy(&Header, Content.data(), sizeof(Header));
+
+    //a snapshot of an older Clients.txt is ignored and rebuilt from the text file.
+    if (memcmp(Header.Magic, ClientsSnapshotMagic, sizeof(Header.Magic)) != 0
+        || Header.SourceFileSize != SourceFileSize || Header.SourceWriteTime != SourceWriteTime)
+        return false;
+
+    size_t Count = Header.RecordsCount;
+    const char* AccountNumbers = Content.data() + sizeof(Header);
+    const char* HeapStrings = AccountNumbers + Count * SnapshotAccountNumberWidth;
+    const char* FileOffsets = HeapStrings + Count * 3 * sizeof(stHeapString);
+    const char* LineLengths = FileOffsets + Count * sizeof(int64_t);
+    const char* Balances = LineLengths + Count * sizeof(uint32_t);
+    const char* Heap = Balances + Count * sizeof(int64_t);
+
+    if ((size_t)(Heap - Content.data()) + Header.HeapSize != Content.length())
+        return false;
+
+    vClients.resize(Count);
+
+    for (size_t i = 0; i < Count; i++)
+    {
+        sClient& Client = vClients[i];
+        const char* AccountNumber = AccountNumbers + i * SnapshotAccountNumberWidth;
+        Client.AccountNumber.assign(AccountNumber, strnlen(AccountNumber, SnapshotAccountNumberWidth));
+
+        stHeapString PinCode = ReadColumnValue<stHeapString>(HeapStrings, i * 3);
+        stHeapString Name = ReadColumnValue<stHeapString>(HeapStrings, i * 3 + 1);
+        stHeapString Phone = ReadColumnValue<stHeapString>(HeapStrings, i * 3 + 2);
+        Client.PinCode.assign(Heap + PinCode.Offset, PinCode.Length);
+        Client.Name.assign(Heap + Name.Offset, Name.Length);
+        Client.Phone.assign(Heap + Phone.Offset, Phone.Length);
+
+        Client.FileOffset = ReadColumnValue<int64_t>(FileOffsets, i);
+        Client.LineLength = ReadColumnValue<uint32_t>(LineLengths, i);
+        Client.AccountBalance = Money::fromCents(ReadColumnValue<int64_t>(Balances, i));
+    }
+    return true;
+}
+
+void RebuildClientsIndex()
+{
+    ClientsIndex.RecordByAccountNumber.clear();
+    ClientsIndex.RecordByAccountNumber.reserve(ClientsIndex.vClients.size());
+
+    for (size_t i = 0; i < ClientsIndex.vClients.size(); i++)
+    {
+        if (ClientsIndex.vClients[i].MarkForDelete == false)
+            ClientsIndex.RecordByAccountNumber[ClientsIndex.vClients[i].AccountNumber] = i;
+    }
+}
+
+void ReplayClientsLog(const string& FileName)
+{
+    //log lines are "U#//#<client record>" for updates and "D#//#<account number>" for deletes.
+    //every record ends with '\n', a last line without one was torn by a crash and is cut off
+    //so the next record starts on a line of its own. Lines that do not parse are skipped.
+    string Content = ReadFileContent(FileName);
+    string_view Log = Content;
+    sClient Client;
+
+    size_t LineStart = 0;
+    while (LineStart < Log.length())
     {
-        string Line;
-        sClient Client;
+        size_t LineEnd = Log.find('\n', LineStart);
+        if (LineEnd == string_view::npos)
+        {
+            error_code Error;
+            filesystem::resize_file(FileName, LineStart, Error);
+            break;
+        }
+
+        string_view Line = Log.substr(LineStart, LineEnd - LineStart);
+        LineStart = LineEnd + 1;
+
+        if (!Line.empty() && Line.back() == '\r')
+            Line.remove_suffix(1);
+
+        if (Line.length() < 6 || Line.substr(1, 4) != "#//#")
+            continue;
 
-        while (getline(MyFile, Line))
+        char Operation = Line[0];
+        Line.remove_prefix(5);
+
+        if (Operation == 'U')
         {
-            Client = ConvertLinetoRecord(Line);
-            if (Client.AccountNumber == AccountNumber)
+            if (!ParseClientLine(Line, Client) || Client.AccountNumber.empty())
+                continue;
+
+            Client.FileOffset = -1;
+            Client.LineLength = 0;
+            auto Record = ClientsIndex.RecordByAccountNumber.emplace(Client.AccountNumber, ClientsIndex.vClients.size());
+
+            //a new client's row is live, only a row it replaces is dead. AddNewClient counts it the same way.
+            if (Record.second)
             {
-                MyFile.close();
-                return true;
+                ClientsIndex.vClients.push_back(move(Client));
+                continue;
             }
-            vClients.push_back(Client);
+
+            ClientsIndex.vClients[Record.first->second] = move(Client);
         }
+        else if (Operation == 'D')
+        {
+            auto Record = ClientsIndex.RecordByAccountNumber.find(string(Line));
 
-        MyFile.close();
+            if (Record != ClientsIndex.RecordByAccountNumber.end())
+            {
+                ClientsIndex.vClients[Record->second].MarkForDelete = true;
+                ClientsIndex.RecordByAccountNumber.erase(Record);
+            }
+        }
+        else
+        {
+            continue;
+        }
 
+        ClientsIndex.DeadRecords++;
     }
-    return false;
+}
+
+stClientsIndex& GetClientsIndex()
+{
+    //the file is read and indexed once, every screen after that works on the index.
+    if (!ClientsIndex.IsLoaded)
+    {
+        if (!LoadClientsSnapshot(ClientsSnapshotFileName, ClientsFileName, ClientsIndex.vClients))
+        {
+            ClientsIndex.vClients = LoadCleintsDataFromFile(ClientsFileName);
+            SaveClientsSnapshot(ClientsSnapshotFileName, ClientsFileName, ClientsIndex.vClients);
+        }
+        RebuildClientsIndex();
+        ReplayClientsLog(ClientsLogFileName);
+        ClientsIndex.IsLoaded = true;
+    }
+    return ClientsIndex;
+}
+
+void ResetClientsIndex()
+{
+    //the next GetClientsIndex() loads the client files again.
+    ClientsIndex.vClients.clear();
+    ClientsIndex.RecordByAccountNumber.clear();
+    ClientsIndex.DeadRecords = 0;
+    ClientsIndex.IsLoaded = false;
+}
+
+bool ClientExistsByAccountNumber(const string& AccountNumber)
+{
+    stClientsIndex& Index = GetClientsIndex();
+    return Index.RecordByAccountNumber.find(AccountNumber) != Index.RecordByAccountNumber.end();
 }
 
 sClient ReadNewClient()
@@ -111,7 +511,7 @@ sClient ReadNewClient()
     // Usage of std::ws will extract allthe whitespace character
     getline(cin >> ws, Client.AccountNumber);
 
-    while (ClientExistsByAccountNumber(Client.AccountNumber, ClientsFileName))
+    while (ClientExistsByAccountNumber(Client.AccountNumber))
     {
         cout << "\nClient with [" << Client.AccountNumber << "] already exists, Enter another Account Number? ";
         getline(cin >> ws, Client.AccountNumber);
@@ -132,28 +532,7 @@ sClient ReadNewClient()
     return Client;
 }
 
-vector <sClient> LoadCleintsDataFromFile(string FileName)
-{
-    vector <sClient> vClients;
-    fstream MyFile;
-    MyFile.open(FileName, ios::in);//read Mode
-
-    if (MyFile.is_open())
-    {
-        string Line;
-        sClient Client;
-
-        while (getline(MyFile, Line))
-        {
-            Client = ConvertLinetoRecord(Line);
-            vClients.push_back(Client);
-        }
-        MyFile.close();
-    }
-    return vClients;
-}
-
-void PrintClientRecordLine(sClient Client)
+void PrintClientRecordLine(const sClient& Client)
 {
     cout << "| " << setw(15) << left << Client.AccountNumber;
     cout << "| " << setw(10) << left << Client.PinCode;
@@ -164,9 +543,9 @@ void PrintClientRecordLine(sClient Client)
 
 void ShowAllClientsScreen()
 {
-    vector <sClient> vClients = LoadCleintsDataFromFile(ClientsFileName);
+    vector <sClient>& vClients = GetClientsIndex().vClients;
 
-    cout << "\n\t\t\t\t\tClient List (" << vClients.size() << ") Client(s).";
+    cout << "\n\t\t\t\t\tClient List (" << GetClientsIndex().RecordByAccountNumber.size() << ") Client(s).";
     cout << "\n_______________________________________________________";
     cout << "_________________________________________\n" << endl;
 
@@ -178,12 +557,14 @@ void ShowAllClientsScreen()
     cout << "\n_______________________________________________________";
     cout << "_________________________________________\n" << endl;
 
-    if (vClients.size() == 0)
+    if (GetClientsIndex().RecordByAccountNumber.size() == 0)
         cout << "\t\t\t\tNo Clients Available In the System!";
     else
 
-        for (sClient Client : vClients)
+        for (const sClient& Client : vClients)
         {
+            if (Client.MarkForDelete)
+                continue;
 
             PrintClientRecordLine(Client);
             cout << endl;
@@ -193,7 +574,7 @@ void ShowAllClientsScreen()
     cout << "_________________________________________\n" << endl;
 }
 
-void PrintClientCard(sClient Client)
+void PrintClientCard(const sClient& Client)
 {
     cout << "\nThe following are the client details:\n";
     cout << "-----------------------------------";
@@ -205,22 +586,25 @@ void PrintClientCard(sClient Client)
     cout << "\n-----------------------------------\n";
 }
 
-bool FindClientByAccountNumber(string AccountNumber, vector <sClient> vClients, sClient& Client)
+mutex& GetClientLock(const string& AccountNumber)
 {
-    for (sClient C : vClients)
-    {
+    return ClientLockShards[hash<string>{}(AccountNumber) % ClientLockShardsCount];
+}
 
-        if (C.AccountNumber == AccountNumber)
-        {
-            Client = C;
-            return true;
-        }
+const sClient* FindClientByAccountNumber(const string& AccountNumber)
+{
+    //returns a view into the index, nullptr when the client is not found.
+    //while tellers are running the caller must hold ClientsIndexLock and the client's lock.
+    stClientsIndex& Index = GetClientsIndex();
+    auto Record = Index.RecordByAccountNumber.find(AccountNumber);
 
-    }
-    return false;
+    if (Record == Index.RecordByAccountNumber.end())
+        return nullptr;
+
+    return &Index.vClients[Record->second];
 }
 
-sClient ChangeClientRecord(string AccountNumber)
+sClient ChangeClientRecord(const string& AccountNumber)
 {
     sClient Client;
 
@@ -240,69 +624,247 @@ sClient ChangeClientRecord(string AccountNumber)
     return Client;
 }
 
-bool MarkClientForDeleteByAccountNumber(string AccountNumber, vector <sClient>& vClients)
+bool MarkClientForDeleteByAccountNumber(const string& AccountNumber)
+{
+    stClientsIndex& Index = GetClientsIndex();
+    auto Record = Index.RecordByAccountNumber.find(AccountNumber);
+
+    if (Record == Index.RecordByAccountNumber.end())
+        return false;
+
+    Index.vClients[Record->second].MarkForDelete = true;
+    Index.RecordByAccountNumber.erase(Record);
+    return true;
+}
+
+void ReplaceFileContent(const string& FileName, const string& Content)
 {
+    //the new file is written next to the old one and renamed over it, so readers never see half a file.
+    string TempFileName = FileName + ".tmp";
+    fstream MyFile;
+    MyFile.open(TempFileName, ios::out | ios::binary);//overwrite
 
-    for (sClient& C : vClients)
+    if (MyFile.is_open())
     {
+        MyFile << Content;
+        MyFile.close();
+        filesystem::rename(TempFileName, FileName);
+    }
+}
 
-        if (C.AccountNumber == AccountNumber)
+void SaveCleintsDataToFile(const string& FileName, const vector <sClient>& vClients)
+{
+    string Content;
+
+    for (const sClient& C : vClients)
+    {
+
+        if (C.MarkForDelete == false)
         {
-            C.MarkForDelete = true;
-            return true;
+            //we only write records that are not marked for delete.  
+            AppendRecordToLine(Content, C);
+            Content += '\n';
         }
 
     }
 
-    return false;
+    ReplaceFileContent(FileName, Content);
 }
 
-vector <sClient> SaveCleintsDataToFile(string FileName, vector <sClient> vClients)
+long long AddDataLineToFile(const string& FileName, const string& stDataLine)
 {
     fstream MyFile;
-    MyFile.open(FileName, ios::out);//overwrite
+    MyFile.open(FileName, ios::out | ios::app | ios::binary);
 
-    string DataLine;
+    long long LineOffset = -1;
 
     if (MyFile.is_open())
     {
-        for (sClient C : vClients)
-        {
+        MyFile.seekp(0, ios::end);
+        LineOffset = MyFile.tellp();
 
-            if (C.MarkForDelete == false)
-            {
-                //we only write records that are not marked for delete.  
-                DataLine = ConvertRecordToLine(C);
-                MyFile << DataLine << endl;
-            }
+        MyFile << stDataLine << '\n';
+
+        MyFile.close();
+        if (MyFile.fail())
+            LineOffset = -1;
+    }
+    return LineOffset;
+}
+
+bool PatchDataLineInFile(const string& FileName, long long LineOffset, const string& stDataLine)
+{
+    fstream MyFile;
+    MyFile.open(FileName, ios::in | ios::out | ios::binary);
+
+    if (!MyFile.is_open())
+        return false;
+
+    MyFile.seekp(LineOffset);
+    MyFile << stDataLine;
+    MyFile.close();
+    return true;
+}
+
+void CompactClientsFile()
+{
+    //live records are moved down over the deleted ones and formatted once, straight into the new file content.
+    vector <sClient>& vClients = ClientsIndex.vClients;
+    size_t Kept = 0;
+    string Content;
 
+    for (size_t i = 0; i < vClients.size(); i++)
+    {
+        if (vClients[i].MarkForDelete == false)
+        {
+            if (Kept != i)
+                vClients[Kept] = move(vClients[i]);
+
+            vClients[Kept].FileOffset = Content.length();
+            vClients[Kept].LineLength = AppendRecordToLine(Content, vClients[Kept]);
+            Content += '\n';
+            Kept++;
         }
+    }
 
-        MyFile.close();
+    vClients.resize(Kept);
+    ReplaceFileContent(ClientsFileName, Content);
+
+    //everything in the log is now part of Clients.txt.
+    fstream LogFile;
+    LogFile.open(ClientsLogFileName, ios::out | ios::trunc);
+    LogFile.close();
+
+    ClientsIndex.DeadRecords = 0;
+    RebuildClientsIndex();
+    SaveClientsSnapshot(ClientsSnapshotFileName, ClientsFileName, vClients);
+}
+
+bool IsCompactionNeeded()
+{
+    double TotalRecords = ClientsIndex.RecordByAccountNumber.size() + ClientsIndex.DeadRecords;
+    return TotalRecords > 0 && ClientsIndex.DeadRecords / TotalRecords >= CompactionDeadRecordsRatio;
+}
+
+void CompactClientsFileIfNeeded()
+{
+    {
+        shared_lock <shared_mutex> IndexLock(ClientsIndexLock);
+        if (!IsCompactionNeeded())
+            return;
     }
 
-    return vClients;
+    unique_lock <shared_mutex> IndexLock(ClientsIndexLock);
+    lock_guard <mutex> FilesLock(ClientsFilesLock);
+
+    //another teller may have compacted while we were waiting for the lock.
+    if (IsCompactionNeeded())
+        CompactClientsFile();
 }
 
-void AddDataLineToFile(string FileName, string  stDataLine)
+void WriteClientUpdate(sClient& Client, sClient NewClient)
 {
-    fstream MyFile;
-    MyFile.open(FileName, ios::out | ios::app);
+    //caller holds ClientsIndexLock shared and the client's lock. Rows of different clients never overlap and
+    //Clients.txt is only appended to or rewritten under ClientsIndexLock exclusive, so patching the client's
+    //own row needs no file lock. Appends to Clients.log do.
+    string DataLine = ConvertRecordToLine(NewClient);
 
-    if (MyFile.is_open())
+    if (Client.FileOffset >= 0 && Client.LineLength == DataLine.length()
+        && PatchDataLineInFile(ClientsFileName, Client.FileOffset, DataLine))
     {
+        //same width as the old row, so it is overwritten where it is.
+        NewClient.FileOffset = Client.FileOffset;
+        NewClient.LineLength = Client.LineLength;
+        Client = move(NewClient);
+        return;
+    }
 
-        MyFile << stDataLine << endl;
+    //the log now holds the current row. The old Clients.txt row must not be patched again,
+    //replaying the log on load would put this row back over the patch.
+    lock_guard <mutex> FilesLock(ClientsFilesLock);
+    AddDataLineToFile(ClientsLogFileName, "U#//#" + DataLine);
+    Client = move(NewClient);
+    Client.FileOffset = -1;
+    Client.LineLength = 0;
+    ClientsIndex.DeadRecords++;
+}
 
-        MyFile.close();
+bool UpdateClientInStore(sClient NewClient)
+{
+    {
+        shared_lock <shared_mutex> IndexLock(ClientsIndexLock);
+        lock_guard <mutex> ClientLock(GetClientLock(NewClient.AccountNumber));
+
+        auto Record = ClientsIndex.RecordByAccountNumber.find(NewClient.AccountNumber);
+        if (Record == ClientsIndex.RecordByAccountNumber.end())
+            return false;
+
+        WriteClientUpdate(ClientsIndex.vClients[Record->second], move(NewClient));
+    }
+
+    CompactClientsFileIfNeeded();
+    return true;
+}
+
+bool DepositToClientByAccountNumber(const string& AccountNumber, Money Amount)
+{
+    {
+        shared_lock <shared_mutex> IndexLock(ClientsIndexLock);
+        lock_guard <mutex> ClientLock(GetClientLock(AccountNumber));
+
+        auto Record = ClientsIndex.RecordByAccountNumber.find(AccountNumber);
+        if (Record == ClientsIndex.RecordByAccountNumber.end())
+            return false;
+
+        sClient& Client = ClientsIndex.vClients[Record->second];
+        sClient NewClient = Client;
+        NewClient.AccountBalance += Amount;
+        WriteClientUpdate(Client, move(NewClient));
     }
+
+    CompactClientsFileIfNeeded();
+    return true;
+}
+
+bool DeleteClientFromStore(const string& AccountNumber)
+{
+    {
+        unique_lock <shared_mutex> IndexLock(ClientsIndexLock);
+        if (!MarkClientForDeleteByAccountNumber(AccountNumber))
+            return false;
+
+        lock_guard <mutex> FilesLock(ClientsFilesLock);
+        AddDataLineToFile(ClientsLogFileName, "D#//#" + AccountNumber);
+        ClientsIndex.DeadRecords++;
+    }
+
+    CompactClientsFileIfNeeded();
+    return true;
 }
 
 void AddNewClient()
 {
     sClient Client;
     Client = ReadNewClient();
-    AddDataLineToFile(ClientsFileName, ConvertRecordToLine(Client));
+
+    stClientsIndex& Index = GetClientsIndex();
+    string DataLine = ConvertRecordToLine(Client);
+    unique_lock <shared_mutex> IndexLock(ClientsIndexLock);
+    lock_guard <mutex> FilesLock(ClientsFilesLock);
+
+    if (Index.DeadRecords == 0)
+    {
+        Client.FileOffset = AddDataLineToFile(ClientsFileName, DataLine);
+        Client.LineLength = DataLine.length();
+    }
+    else
+    {
+        //the log may hold a delete for this account number, so the new client must be replayed after it.
+        AddDataLineToFile(ClientsLogFileName, "U#//#" + DataLine);
+    }
+
+    Index.RecordByAccountNumber[Client.AccountNumber] = Index.vClients.size();
+    Index.vClients.push_back(move(Client));
 }
 
 void AddNewClients()
@@ -321,25 +883,117 @@ void AddNewClients()
 
 }
 
-bool DeleteClientByAccountNumber(string AccountNumber, vector <sClient>& vClients)
+struct stImportResult
+{
+    size_t AcceptedRows = 0;
+    size_t DuplicateRows = 0;
+    size_t InvalidRows = 0;
+    bool WriteFailed = false;
+    double Seconds = 0;
+};
+
+stImportResult ImportClientsFromFile(const string& FileName)
 {
+    //rows are AccountNumber, PinCode, Name, Phone, AccountBalance separated by tabs (TSV) or commas (CSV).
+    stImportResult Result;
+    auto StartTime = chrono::steady_clock::now();
+
+    string Content = ReadFileContent(FileName);
+    string_view Data = Content;
+    size_t FirstLineEnd = Data.find('\n');
+    string_view Seperator = Data.substr(0, FirstLineEnd).find('\t') != string_view::npos ? "\t" : ",";
+
+    stClientsIndex& Index = GetClientsIndex();
+    unique_lock <shared_mutex> IndexLock(ClientsIndexLock);
+    lock_guard <mutex> FilesLock(ClientsFilesLock);
+    bool WriteToLog = Index.DeadRecords > 0; //same rule as AddNewClient, a delete in the log must be replayed first.
+    string Buffer;
+    vector <size_t> vLineStarts;
+    vector <sClient> vNewClients;
+    unordered_set <string> NewAccountNumbers;
     sClient Client;
+
+    size_t LineStart = 0;
+    while (LineStart < Data.length())
+    {
+        size_t LineEnd = Data.find('\n', LineStart);
+        if (LineEnd == string_view::npos)
+            LineEnd = Data.length();
+
+        string_view Line = Data.substr(LineStart, LineEnd - LineStart);
+        if (!Line.empty() && Line.back() == '\r')
+            Line.remove_suffix(1);
+        LineStart = LineEnd + 1;
+
+        if (Line.empty())
+            continue;
+
+        //a header row or a malformed row fails here and is skipped.
+        if (!ParseClientLine(Line, Client, Seperator) || Client.AccountNumber.empty())
+        {
+            Result.InvalidRows++;
+            continue;
+        }
+
+        if (Index.RecordByAccountNumber.count(Client.AccountNumber) || !NewAccountNumbers.insert(Client.AccountNumber).second)
+        {
+            Result.DuplicateRows++;
+            continue;
+        }
+
+        if (WriteToLog)
+            Buffer += "U#//#";
+
+        vLineStarts.push_back(Buffer.length());
+        Client.FileOffset = -1;
+        Client.LineLength = AppendRecordToLine(Buffer, Client);
+        vNewClients.push_back(move(Client));
+        Buffer += '\n';
+    }
+
+    if (!Buffer.empty())
+    {
+        //all accepted rows go to disk in one write, and join the index only once they are there.
+        Buffer.pop_back();
+        long long BufferOffset = AddDataLineToFile(WriteToLog ? ClientsLogFileName : ClientsFileName, Buffer);
+
+        if (BufferOffset < 0)
+        {
+            Result.WriteFailed = true;
+            Result.Seconds = chrono::duration<double>(chrono::steady_clock::now() - StartTime).count();
+            return Result;
+        }
+
+        for (size_t i = 0; i < vNewClients.size(); i++)
+        {
+            if (!WriteToLog)
+                vNewClients[i].FileOffset = BufferOffset + vLineStarts[i];
+
+            Index.RecordByAccountNumber[vNewClients[i].AccountNumber] = Index.vClients.size();
+            Index.vClients.push_back(move(vNewClients[i]));
+        }
+        Result.AcceptedRows = vNewClients.size();
+    }
+
+    Result.Seconds = chrono::duration<double>(chrono::steady_clock::now() - StartTime).count();
+    return Result;
+}
+
+bool DeleteClientByAccountNumber(const string& AccountNumber)
+{
     char Answer = 'n';
+    const sClient* Client = FindClientByAccountNumber(AccountNumber);
 
-    if (FindClientByAccountNumber(AccountNumber, vClients, Client))
+    if (Client != nullptr)
     {
 
-        PrintClientCard(Client);
+        PrintClientCard(*Client);
 
         cout << "\n\nAre you sure you want delete this client? y/n ? ";
         cin >> Answer;
         if (Answer == 'y' || Answer == 'Y')
         {
-            MarkClientForDeleteByAccountNumber(AccountNumber, vClients);
-            SaveCleintsDataToFile(ClientsFileName, vClients);
-
-            //Refresh Clients 
-            vClients = LoadCleintsDataFromFile(ClientsFileName);
+            DeleteClientFromStore(AccountNumber);
 
             cout << "\n\nClient Deleted Successfully.";
             return true;
@@ -349,34 +1003,25 @@ bool DeleteClientByAccountNumber(string AccountNumber, vector <sClient>& vClient
     else
     {
         cout << "\nClient with Account Number (" << AccountNumber << ") is Not Found!";
-        return false;
     }
+    return false;
 }
 
-bool UpdateClientByAccountNumber(string AccountNumber, vector <sClient>& vClients)
+bool UpdateClientByAccountNumber(const string& AccountNumber)
 {
 
-    sClient Client;
     char Answer = 'n';
+    const sClient* Client = FindClientByAccountNumber(AccountNumber);
 
-    if (FindClientByAccountNumber(AccountNumber, vClients, Client))
+    if (Client != nullptr)
     {
 
-        PrintClientCard(Client);
+        PrintClientCard(*Client);
         cout << "\n\nAre you sure you want update this client? y/n ? ";
         cin >> Answer;
         if (Answer == 'y' || Answer == 'Y')
         {
-            for (sClient& C : vClients)
-            {
-                if (C.AccountNumber == AccountNumber)
-                {
-                    C = ChangeClientRecord(AccountNumber);
-                    break;
-                }
-            }
-
-            SaveCleintsDataToFile(ClientsFileName, vClients);
+            UpdateClientInStore(ChangeClientRecord(AccountNumber));
 
             cout << "\n\nClient Updated Successfully.";
             return true;
@@ -386,8 +1031,8 @@ bool UpdateClientByAccountNumber(string AccountNumber, vector <sClient>& vClient
     else
     {
         cout << "\nClient with Account Number (" << AccountNumber << ") is Not Found!";
-        return false;
     }
+    return false;
 }
 
 string ReadClientAccountNumber()
@@ -406,9 +1051,8 @@ void ShowDeleteClientScreen()
     cout << "\tDelete Client Screen";
     cout << "\n-----------------------------------\n";
 
-    vector <sClient> vClients = LoadCleintsDataFromFile(ClientsFileName);
     string AccountNumber = ReadClientAccountNumber();
-    DeleteClientByAccountNumber(AccountNumber, vClients);
+    DeleteClientByAccountNumber(AccountNumber);
 }
 
 void ShowUpdateClientScreen()
@@ -417,9 +1061,8 @@ void ShowUpdateClientScreen()
     cout << "\tUpdate Client Info Screen";
     cout << "\n-----------------------------------\n";
 
-    vector <sClient> vClients = LoadCleintsDataFromFile(ClientsFileName);
     string AccountNumber = ReadClientAccountNumber();
-    UpdateClientByAccountNumber(AccountNumber, vClients);
+    UpdateClientByAccountNumber(AccountNumber);
 
 }
 
@@ -438,15 +1081,189 @@ void ShowFindClientScreen()
     cout << "\tFind Client Screen";
     cout << "\n-----------------------------------\n";
 
-    vector <sClient> vClients = LoadCleintsDataFromFile(ClientsFileName);
-    sClient Client;
     string AccountNumber = ReadClientAccountNumber();
-    if (FindClientByAccountNumber(AccountNumber, vClients, Client))
-        PrintClientCard(Client);
+    const sClient* Client = FindClientByAccountNumber(AccountNumber);
+    if (Client != nullptr)
+        PrintClientCard(*Client);
     else
         cout << "\nClient with Account Number[" << AccountNumber << "] is not found!";
 }
 
+void ShowImportClientsScreen()
+{
+    cout << "\n-----------------------------------\n";
+    cout << "\tImport Clients Screen";
+    cout << "\n-----------------------------------\n";
+
+    string FileName;
+    cout << "\nPlease enter CSV/TSV file name? ";
+    getline(cin >> ws, FileName);
+
+    stImportResult Result = ImportClientsFromFile(FileName);
+
+    if (Result.WriteFailed)
+        cout << "\nCould not write the clients file, nothing was imported.";
+
+    cout << "\nImported Clients : " << Result.AcceptedRows;
+    cout << "\nDuplicate Rows   : " << Result.DuplicateRows;
+    cout << "\nInvalid Rows     : " << Result.InvalidRows;
+    if (Result.Seconds > 0)
+        cout << "\nRows Per Second  : " << (long long)((Result.AcceptedRows + Result.DuplicateRows + Result.InvalidRows) / Result.Seconds);
+}
+
+struct stTellerStats
+{
+    size_t Finds = 0;
+    size_t Updates = 0;
+    size_t Deletes = 0;
+};
+
+bool ReadClientBalanceByAccountNumber(const string& AccountNumber, Money& AccountBalance)
+{
+    shared_lock <shared_mutex> IndexLock(ClientsIndexLock);
+    lock_guard <mutex> ClientLock(GetClientLock(AccountNumber));
+
+    const sClient* Client = FindClientByAccountNumber(AccountNumber);
+    if (Client == nullptr)
+        return false;
+
+    AccountBalance = Client->AccountBalance;
+    return true;
+}
+
+void RunTellerSession(unsigned TellerNumber, size_t OperationsCount, const vector <string>& vAccountNumbers, stTellerStats& Stats)
+{
+    //80% finds, 18% deposits and 2% deletes on random accounts.
+    mt19937 Random(TellerNumber + 1);
+    Money AccountBalance;
+
+    for (size_t i = 0; i < OperationsCount; i++)
+    {
+        const string& AccountNumber = vAccountNumbers[Random() % vAccountNumbers.size()];
+        unsigned Operation = Random() % 100;
+
+        if (Operation < 80)
+        {
+            if (ReadClientBalanceByAccountNumber(AccountNumber, AccountBalance))
+                Stats.Finds++;
+        }
+        else if (Operation < 98)
+        {
+            if (DepositToClientByAccountNumber(AccountNumber, Money::fromCents(100)))
+                Stats.Updates++;
+        }
+        else if (DeleteClientFromStore(AccountNumber))
+        {
+            Stats.Deletes++;
+        }
+    }
+}
+
+struct stScratchDirectory
+{
+    //work in a folder of our own: the constructor changes into it, the destructor goes back and removes it,
+    //also when an exception leaves the scope.
+    filesystem::path PreviousDirectory;
+    filesystem::path Directory;
+
+    stScratchDirectory(const string& FolderName)
+        : PreviousDirectory(filesystem::current_path()), Directory(PreviousDirectory / FolderName)
+    {
+        filesystem::create_directories(Directory);
+        filesystem::current_path(Directory);
+    }
+
+    ~stScratchDirectory()
+    {
+        error_code Error;
+        filesystem::current_path(PreviousDirectory, Error);
+        filesystem::remove_all(Directory, Error);
+    }
+};
+
+void GenerateSimulationClients(const string& FileName, size_t ClientsCount)
+{
+    string Buffer;
+    sClient Client;
+
+    for (size_t i = 1; i <= ClientsCount; i++)
+    {
+        Client.AccountNumber = "T" + to_string(100000 + i);
+        Client.PinCode = "1234";
+        Client.Name = "Teller Client " + to_string(i);
+        Client.Phone = to_string(790000000 + i);
+        Client.AccountBalance = Money::fromCents(100000);
+        Buffer += ConvertRecordToLine(Client) + '\n';
+    }
+
+    fstream MyFile;
+    MyFile.open(FileName, ios::out | ios::binary);//overwrite
+    MyFile << Buffer;
+    MyFile.close();
+}
+
+void ShowTellerSimulationScreen()
+{
+    cout << "\n-----------------------------------\n";
+    cout << "\tMulti Teller Simulation Screen";
+    cout << "\n-----------------------------------\n";
+
+    const short vTellersCounts[] = { 1, 2, 4, 8, 16, 32, 64 };
+    const size_t SimulationClientsCount = 10000;
+    const size_t OperationsPerRun = 64000;
+
+    //tellers work on generated clients in their own folder, the real Clients.txt is not touched.
+    stScratchDirectory SimulationDirectory("TellerSimulation");
+
+    cout << "\n| " << left << setw(10) << "Tellers";
+    cout << "| " << left << setw(16) << "Operations/sec";
+    cout << "| " << left << setw(10) << "Finds";
+    cout << "| " << left << setw(10) << "Updates";
+    cout << "| " << left << setw(10) << "Deletes";
+    cout << "\n_____________________________________________________________\n";
+
+    for (short TellersCount : vTellersCounts)
+    {
+        GenerateSimulationClients(ClientsFileName, SimulationClientsCount);
+        filesystem::remove(ClientsLogFileName);
+        filesystem::remove(ClientsSnapshotFileName);
+        ResetClientsIndex();
+
+        vector <string> vAccountNumbers;
+        for (const sClient& Client : GetClientsIndex().vClients)
+            vAccountNumbers.push_back(Client.AccountNumber);
+
+        vector <stTellerStats> vStats(TellersCount);
+        vector <thread> vTellers;
+        auto StartTime = chrono::steady_clock::now();
+
+        for (short i = 0; i < TellersCount; i++)
+            vTellers.emplace_back(RunTellerSession, i, OperationsPerRun / TellersCount, cref(vAccountNumbers), ref(vStats[i]));
+
+        for (thread& Teller : vTellers)
+            Teller.join();
+
+        double Seconds = chrono::duration<double>(chrono::steady_clock::now() - StartTime).count();
+
+        stTellerStats Total;
+        for (const stTellerStats& Stats : vStats)
+        {
+            Total.Finds += Stats.Finds;
+            Total.Updates += Stats.Updates;
+            Total.Deletes += Stats.Deletes;
+        }
+
+        cout << "| " << left << setw(10) << TellersCount;
+        cout << "| " << left << setw(16) << (long long)(OperationsPerRun / Seconds);
+        cout << "| " << left << setw(10) << Total.Finds;
+        cout << "| " << left << setw(10) << Total.Updates;
+        cout << "| " << left << setw(10) << Total.Deletes << endl;
+    }
+
+    cout << "\nDeposits patch their own row in place, deposits that change its width and deletes share one log lock.\n";
+    ResetClientsIndex();
+}
+
 void ShowEndScreen()
 {
     cout << "\n-----------------------------------\n";
@@ -458,7 +1275,8 @@ enum enMainMenueOptions
 {
     eListClients = 1, eAddNewClient = 2,
     eDeleteClient = 3, eUpdateClient = 4,
-    eFindClient = 5, eExit = 6
+    eFindClient = 5, eImportClients = 6,
+    eTellerSimulation = 7, eExit = 8
 };
 
 void GoBackToMainMenue()
@@ -471,7 +1289,7 @@ void GoBackToMainMenue()
 
 short ReadMainMenueOption()
 {
-    cout << "Choose what do you want to do? [1 to 6]? ";
+    cout << "Choose what do you want to do? [1 to 8]? ";
     short Choice = 0;
     cin >> Choice;
 
@@ -513,6 +1331,18 @@ void PerfromMainMenueOption(enMainMenueOptions MainMenueOption)
         GoBackToMainMenue();
         break;
 
+    case enMainMenueOptions::eImportClients:
+        system("cls");
+        ShowImportClientsScreen();
+        GoBackToMainMenue();
+        break;
+
+    case enMainMenueOptions::eTellerSimulation:
+        system("cls");
+        ShowTellerSimulationScreen();
+        GoBackToMainMenue();
+        break;
+
     case enMainMenueOptions::eExit:
         system("cls");
         ShowEndScreen();
@@ -531,14 +1361,358 @@ void ShowMainMenue()
     cout << "\t[3] Delete Client.\n";
     cout << "\t[4] Update Client Info.\n";
     cout << "\t[5] Find Client.\n";
-    cout << "\t[6] Exit.\n";
+    cout << "\t[6] Import Clients From File.\n";
+    cout << "\t[7] Multi Teller Simulation.\n";
+    cout << "\t[8] Exit.\n";
     cout << "===========================================\n";
     PerfromMainMenueOption((enMainMenueOptions)ReadMainMenueOption());
 }
 
-int main()
+//benchmarks run with --benchmark [clients], on generated clients in a folder of their own like the teller simulation.
+
+sClient ConvertLinetoRecordBySplit(const string& Line, const string& Seperator = "#//#")
+{
+    //the parser ParseClientLine replaced: a vector of strings per line, copied into the record, and stod for the balance.
+    vector<string> vClientData = SplitString(Line, Seperator);
+    sClient Client;
+
+    Client.AccountNumber = vClientData[0];
+    Client.PinCode = vClientData[1];
+    Client.Name = vClientData[2];
+    Client.Phone = vClientData[3];
+    Client.AccountBalance = Money::fromDouble(stod(vClientData[4]));
+    return Client;
+}
+
+template <typename ParseLine>
+double TimeClientLinesParse(const string& Content, ParseLine Parse, int64_t& CentsTotal)
+{
+    //every line goes through Parse, the balances are summed so both parsers can be checked against each other.
+    string_view Data = Content;
+    CentsTotal = 0;
+    auto StartTime = chrono::steady_clock::now();
+
+    size_t LineStart = 0;
+    while (LineStart < Data.length())
+    {
+        size_t LineEnd = Data.find('\n', LineStart);
+        if (LineEnd == string_view::npos)
+            LineEnd = Data.length();
+
+        CentsTotal += Parse(Data.substr(LineStart, LineEnd - LineStart)).toCents();
+        LineStart = LineEnd + 1;
+    }
+    return chrono::duration<double>(chrono::steady_clock::now() - StartTime).count();
+}
+
+void RunParserBenchmark(size_t ClientsCount)
+{
+    GenerateSimulationClients(ClientsFileName, ClientsCount);
+    string Content = ReadFileContent(ClientsFileName);
+    int64_t SplitTotal, ParseTotal;
+    sClient Client;
+
+    double SplitSeconds = TimeClientLinesParse(Content, [](string_view Line)
+        {
+            return ConvertLinetoRecordBySplit(string(Line)).AccountBalance;
+        }, SplitTotal);
+
+    double ParseSeconds = TimeClientLinesParse(Content, [&Client](string_view Line)
+        {
+            ParseClientLine(Line, Client);
+            return Client.AccountBalance;
+        }, ParseTotal);
+
+    cout << "\nParsing " << ClientsCount << " client lines (" << Content.length() / (1024 * 1024) << " MB):";
+    cout << "\n  SplitString + stod : " << SplitSeconds << " s, " << (long long)(ClientsCount / SplitSeconds) << " lines/sec";
+    cout << "\n  ParseClientLine    : " << ParseSeconds << " s, " << (long long)(ClientsCount / ParseSeconds) << " lines/sec";
+    cout << "\n  Balances match     : " << (SplitTotal == ParseTotal ? "yes" : "NO") << endl;
+}
+
+size_t GetPeakMemoryBytes()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS Counters;
+    return GetProcessMemoryInfo(GetCurrentProcess(), &Counters, sizeof(Counters)) ? Counters.PeakWorkingSetSize : 0;
+#else
+    rusage Usage;
+    getrusage(RUSAGE_SELF, &Usage);
+    return (size_t)Usage.ru_maxrss * 1024; //kilobytes on Linux
+#endif
+}
+
+string GetProgramPath(const char* ProgramName)
+{
+#ifdef _WIN32
+    char Path[MAX_PATH];
+    DWORD Length = GetModuleFileNameA(nullptr, Path, MAX_PATH);
+    return string(Path, Length);
+#else
+    error_code Error;
+    filesystem::path Path = filesystem::read_symlink("/proc/self/exe", Error);
+    return Error ? filesystem::absolute(ProgramName).string() : Path.string();
+#endif
+}
+
+int RunColdStart(bool TextOnly)
+{
+    //started by RunColdStartBenchmark in a new process, so the peak memory is the load's own.
+    //TextOnly is the start before Clients.snap existed: parse Clients.txt and index it.
+    auto StartTime = chrono::steady_clock::now();
+    if (TextOnly)
+    {
+        ClientsIndex.vClients = LoadCleintsDataFromFile(ClientsFileName);
+        RebuildClientsIndex();
+    }
+    else
+    {
+        GetClientsIndex();
+    }
+    size_t ClientsCount = ClientsIndex.RecordByAccountNumber.size();
+    double Seconds = chrono::duration<double>(chrono::steady_clock::now() - StartTime).count();
+
+    cout << Seconds << ' ' << GetPeakMemoryBytes() << ' ' << ClientsCount << endl;
+    return 0;
+}
+
+void PrintColdStart(const string& ProgramPath, const string& Arguments, const string& Description)
+{
+#ifdef _WIN32
+    //cmd.exe drops the outer pair of quotes, the ones around the program path stay.
+    string Command = "\"\"" + ProgramPath + "\" --cold-start " + Arguments + " > ColdStart.txt\"";
+#else
+    string Command = "\"" + ProgramPath + "\" --cold-start " + Arguments + " > ColdStart.txt";
+#endif
+
+    double Seconds = 0;
+    size_t PeakBytes = 0, ClientsCount = 0;
+    if (system(Command.c_str()) == 0)
+    {
+        stringstream Output(ReadFileContent("ColdStart.txt"));
+        Output >> Seconds >> PeakBytes >> ClientsCount;
+    }
+
+    cout << "\n  " << left << setw(40) << Description << ": " << Seconds << " s, peak memory "
+        << PeakBytes / (1024 * 1024) << " MB, " << ClientsCount << " clients";
+}
+
+void RunColdStartBenchmark(const string& ProgramPath)
+{
+    //the parser benchmark left Clients.txt behind. Without a snapshot a start parses the text
+    //and writes Clients.snap, the start after it loads the snapshot.
+    filesystem::remove(ClientsSnapshotFileName);
+    filesystem::remove(ClientsLogFileName);
+
+    cout << "\nCold start:";
+    PrintColdStart(ProgramPath, "text", "Clients.txt only");
+    PrintColdStart(ProgramPath, "", "Clients.txt, then write Clients.snap");
+    PrintColdStart(ProgramPath, "", "Clients.snap");
+    cout << endl;
+}
+
+int RunBenchmarks(size_t ClientsCount, const string& ProgramPath)
+{
+    stScratchDirectory BenchmarkDirectory("Benchmark");
+
+    RunParserBenchmark(ClientsCount);
+    RunColdStartBenchmark(ProgramPath);
+    return 0;
+}
+
+#ifdef _DEBUG
+//debug builds run these checks with --self-test, in a folder of their own so the real client files are not touched.
+
+bool CheckSelfTest(bool Condition, const string& Description)
+{
+    cout << (Condition ? "[PASS] " : "[FAIL] ") << Description << endl;
+    return Condition;
+}
+
+void WriteTextFile(const string& FileName, const string& Content)
+{
+    fstream MyFile;
+    MyFile.open(FileName, ios::out | ios::binary);//overwrite
+    MyFile << Content;
+    MyFile.close();
+}
+
+void ResetSelfTestFiles(const string& ClientsContent, const string& LogContent)
+{
+    filesystem::remove(ClientsSnapshotFileName);
+    WriteTextFile(ClientsFileName, ClientsContent);
+    WriteTextFile(ClientsLogFileName, LogContent);
+    ResetClientsIndex();
+}
+
+bool TestLogReplaySkipsMalformedAndTornRecords()
+{
+    string CompleteRecords = "U#//#A1#//#1111#//#Ali#//#0791#//#50.00\n"
+        "X#//#A1#//#1111#//#Ali#//#0791#//#99.00\n"
+        "U#//#A2#//#2222\n"
+        "UA2#//#2222#//#Sara#//#0792#//#99.00\n"
+        "D#//#A2\n";
+    ResetSelfTestFiles("A1#//#1111#//#Ali#//#0791#//#10.00\nA2#//#2222#//#Sara#//#0792#//#20.00\n",
+        CompleteRecords + "U#//#A1#//#1111#//#Ali#//#0791#//#7");
+
+    const sClient* Client = FindClientByAccountNumber("A1");
+    bool Passed = true;
+    Passed &= CheckSelfTest(Client != nullptr && Client->AccountBalance == Money::fromCents(5000),
+        "log replay applies complete updates and ignores a torn last record");
+    Passed &= CheckSelfTest(!ClientExistsByAccountNumber("A2") && !ClientExistsByAccountNumber(""),
+        "log replay skips malformed records");
+    Passed &= CheckSelfTest(filesystem::file_size(ClientsLogFileName) == CompleteRecords.length(),
+        "log replay cuts a torn last record off the log");
+    return Passed;
+}
 
+bool TestLogReplayCountsDeadRecordsLikeLiveEdits()
 {
+    //the update of A1 and the delete of A2 leave dead rows, the new client A3 does not.
+    ResetSelfTestFiles("A1#//#1111#//#Ali#//#0791#//#10.00\nA2#//#2222#//#Sara#//#0792#//#20.00\n",
+        "U#//#A3#//#3333#//#Omar#//#0793#//#30.00\nU#//#A1#//#1111#//#Ali#//#0791#//#11.00\nD#//#A2\n");
+
+    GetClientsIndex();
+    return CheckSelfTest(ClientsIndex.DeadRecords == 2, "log replay counts dead records like live edits");
+}
+
+bool TestImportAddsClientsOnlyAfterTheyAreWritten()
+{
+    WriteTextFile("Import.csv", "AccountNumber,PinCode,Name,Phone,AccountBalance\n"
+        "B1,1234,Omar,0791,5.00\n,1234,No Account,0792,5.00\nB1,1234,Omar Again,0793,5.00\n");
+    bool Passed = true;
+
+    //a folder named Clients.txt cannot be appended to, so the write fails.
+    ResetSelfTestFiles("", "");
+    filesystem::remove(ClientsFileName);
+    filesystem::create_directory(ClientsFileName);
+    stImportResult Result = ImportClientsFromFile("Import.csv");
+    Passed &= CheckSelfTest(Result.WriteFailed && Result.AcceptedRows == 0 && !ClientExistsByAccountNumber("B1"),
+        "import leaves the index alone when the write fails");
+    filesystem::remove(ClientsFileName);
+
+    ResetSelfTestFiles("", "");
+    Result = ImportClientsFromFile("Import.csv");
+    ResetClientsIndex();
+    Passed &= CheckSelfTest(!Result.WriteFailed && Result.AcceptedRows == 1 && Result.DuplicateRows == 1 && Result.InvalidRows == 2
+        && ClientExistsByAccountNumber("B1") && !ClientExistsByAccountNumber(""), "import rejects empty and duplicate account numbers");
+    return Passed;
+}
+
+bool CheckAllocationsBelow(size_t AllocationsBefore, size_t Limit, const string& Description)
+{
+    size_t Allocations = HeapAllocationsCount - AllocationsBefore;
+    return CheckSelfTest(Allocations < Limit, Description + " (" + to_string(Allocations) + " allocations)");
+}
+
+bool TestMenuActionsDoNotCopyClientTable()
+{
+    //names and phones are longer than the small string buffer, so copying the table costs
+    //at least one allocation per client. Every action must stay well below that.
+    const size_t ClientsCount = 2000;
+    string Clients;
+    sClient Client;
+    for (size_t i = 1; i <= ClientsCount; i++)
+    {
+        Client.AccountNumber = "A" + to_string(i);
+        Client.PinCode = "1234";
+        Client.Name = "Self Test Client Number " + to_string(i);
+        Client.Phone = "+962 7 9000 0000 extension " + to_string(i);
+        Client.AccountBalance = Money::fromCents(1000);
+        AppendRecordToLine(Clients, Client);
+        Clients += '\n';
+    }
+    ResetSelfTestFiles(Clients, "");
+    WriteTextFile("Import.csv", "B1,1234,Imported Client With A Long Name,+962 7 9000 0001,5.00\n"
+        "B2,1234,Imported Client With A Long Name,+962 7 9000 0002,5.00\n");
+    GetClientsIndex();
+
+    bool Passed = true;
+    size_t AllocationsBefore = HeapAllocationsCount;
+    FindClientByAccountNumber("A10");
+    Passed &= CheckAllocationsBelow(AllocationsBefore, 1, "find client");
+
+    AllocationsBefore = HeapAllocationsCount;
+    DepositToClientByAccountNumber("A10", Money::fromCents(100));
+    Passed &= CheckAllocationsBelow(AllocationsBefore, ClientsCount / 10, "deposit");
+
+    Client = *FindClientByAccountNumber("A11");
+    Client.Name = "Self Test Client Renamed With A Long Name";
+    AllocationsBefore = HeapAllocationsCount;
+    UpdateClientInStore(move(Client));
+    Passed &= CheckAllocationsBelow(AllocationsBefore, ClientsCount / 10, "update client");
+
+    AllocationsBefore = HeapAllocationsCount;
+    DeleteClientFromStore("A1");
+    Passed &= CheckAllocationsBelow(AllocationsBefore, ClientsCount / 10, "delete client");
+
+    AllocationsBefore = HeapAllocationsCount;
+    ImportClientsFromFile("Import.csv");
+    Passed &= CheckAllocationsBelow(AllocationsBefore, ClientsCount / 10, "import two clients");
+
+    //compaction moves the live records down over the deleted one, their strings keep their buffers.
+    const char* NameBuffer = FindClientByAccountNumber("A2000")->Name.data();
+    CompactClientsFile();
+    const sClient* Moved = FindClientByAccountNumber("A2000");
+    Passed &= CheckSelfTest(Moved != nullptr && Moved->Name.data() == NameBuffer, "compaction moves records instead of copying them");
+
+    ResetClientsIndex();
+    filesystem::remove(ClientsSnapshotFileName);
+    const sClient* Reloaded = FindClientByAccountNumber("A10");
+    Passed &= CheckSelfTest(GetClientsIndex().vClients.size() == ClientsCount + 1 && !ClientExistsByAccountNumber("A1")
+        && Reloaded != nullptr && Reloaded->AccountBalance == Money::fromCents(1100), "compacted file reloads with every change");
+    return Passed;
+}
+
+bool TestUpdateAfterWidthChangeSurvivesReload()
+{
+    //-10.00 -> -9.00 is narrower and goes to the log, -9.00 -> -11.00 has the original width again
+    //but must not be patched into the old Clients.txt row. Other clients keep compaction from running.
+    string Clients = "A1#//#1111#//#Ali#//#0791#//#-10.00\n";
+    for (short i = 2; i <= 10; i++)
+        Clients += "A" + to_string(i) + "#//#1111#//#Client#//#0791#//#0.00\n";
+    ResetSelfTestFiles(Clients, "");
+    GetClientsIndex();
+    DepositToClientByAccountNumber("A1", Money::fromCents(100));
+    DepositToClientByAccountNumber("A1", Money::fromCents(-200));
+
+    ResetClientsIndex();
+    const sClient* Client = FindClientByAccountNumber("A1");
+    return CheckSelfTest(Client != nullptr && Client->AccountBalance == Money::fromCents(-1100),
+        "update after a width change survives reload");
+}
+
+int RunSelfTests()
+{
+    bool Passed = true;
+    {
+        stScratchDirectory SelfTestDirectory("SelfTest");
+        Passed &= TestLogReplaySkipsMalformedAndTornRecords();
+        Passed &= TestLogReplayCountsDeadRecordsLikeLiveEdits();
+        Passed &= TestImportAddsClientsOnlyAfterTheyAreWritten();
+        Passed &= TestMenuActionsDoNotCopyClientTable();
+        Passed &= TestUpdateAfterWidthChangeSurvivesReload();
+    }
+    ResetClientsIndex();
+
+    cout << (Passed ? "\nAll self tests passed.\n" : "\nSome self tests failed.\n");
+    return Passed ? 0 : 1;
+}
+#endif
+
+int main(int argc, char* argv[])
+
+{
+#ifdef _DEBUG
+    if (argc > 1 && string(argv[1]) == "--self-test")
+        return RunSelfTests();
+#endif
+
+    if (argc > 1 && string(argv[1]) == "--benchmark")
+        return RunBenchmarks(argc > 2 ? stoul(argv[2]) : 2000000, GetProgramPath(argv[0]));
+
+    if (argc > 1 && string(argv[1]) == "--cold-start")
+        return RunColdStart(argc > 2 && string(argv[2]) == "text");
+
     ShowMainMenue();
     system("pause>0");
     return 0;
@@ -3,12 +3,25 @@
 #include <vector>
 #include <memory>
 #include <stdexcept>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <fstream>
+#include <filesystem>
+
+#include "../Common/AsyncConsole.h"
+#include "../Common/Money.h"
 
 // --- Interface for Transactions ---
 class ITransaction {
 public:
-    virtual void deposit(double amount) = 0;
-    virtual void withdraw(double amount) = 0;
+    virtual void deposit(Money amount) = 0;
+    virtual void withdraw(Money amount) = 0;
     virtual ~ITransaction() = default;
 };
 
@@ -17,58 +30,83 @@ class Account : public ITransaction {
 protected:
     std::string accountHolder;
     int accountNumber;
-    double balance;
+    Money balance;
+    mutable std::mutex balanceMutex; // guards balance, see transfer() for the locking order
 
 public:
-    Account(const std::string& name, int accNumber, double initialBalance)
+    Account(const std::string& name, int accNumber, Money initialBalance)
         : accountHolder(name), accountNumber(accNumber), balance(initialBalance) {}
 
     virtual ~Account() = default;
 
     virtual void displayBalance() const {
-        std::cout << "Account Holder: " << accountHolder
+        ConsoleMessage() << "Account Holder: " << accountHolder
             << "\nAccount Number: " << accountNumber
-            << "\nBalance: $" << balance << std::endl;
+            << "\nBalance: $" << getBalance() << '\n';
     }
 
     int getAccountNumber() const { return accountNumber; }
 
     // Deposit functionality
-    void deposit(double amount) override {
-        if (amount <= 0) throw std::invalid_argument("Deposit amount must be positive.");
-        balance += amount;
-        std::cout << "$" << amount << " deposited successfully." << std::endl;
+    void deposit(Money amount) override {
+        if (!amount.isPositive()) throw std::invalid_argument("Deposit amount must be positive.");
+        {
+            std::lock_guard<std::mutex> lock(balanceMutex);
+            balance += amount;
+        }
+        ConsoleMessage() << "$" << amount << " deposited successfully." << '\n';
     }
 
     // Withdraw functionality
-    void withdraw(double amount) override {
-        if (amount <= 0) throw std::invalid_argument("Withdrawal amount must be positive.");
-        if (amount > balance) throw std::runtime_error("Insufficient balance.");
-        balance -= amount;
-        std::cout << "$" << amount << " withdrawn successfully." << std::endl;
+    void withdraw(Money amount) override {
+        if (!amount.isPositive()) throw std::invalid_argument("Withdrawal amount must be positive.");
+        {
+            std::lock_guard<std::mutex> lock(balanceMutex);
+            if (amount > balance) throw std::runtime_error("Insufficient balance.");
+            balance -= amount;
+        }
+        ConsoleMessage() << "$" << amount << " withdrawn successfully." << '\n';
     }
 
-    double getBalance() const { return balance; }
+    Money getBalance() const {
+        std::lock_guard<std::mutex> lock(balanceMutex);
+        return balance;
+    }
 
     // Virtual method for transfer - to be overridden by specific account types
-    virtual void transfer(Account& toAccount, double amount) {
-        if (amount <= 0) throw std::invalid_argument("Transfer amount must be positive.");
-        if (amount > balance) throw std::runtime_error("Insufficient balance.");
-        withdraw(amount);
-        toAccount.deposit(amount);
-        std::cout << "$" << amount << " transferred successfully from Account " << accountNumber
-            << " to Account " << toAccount.getAccountNumber() << std::endl;
+    // Both balances change under both locks, so the money in the bank is the same before and after.
+    // Locks are always taken in account-number order, so opposite transfers (A->B and B->A) cannot deadlock.
+    // Accounts that share a number are ordered by address through std::less, which is a total order.
+    virtual void transfer(Account& toAccount, Money amount) {
+        if (!amount.isPositive()) throw std::invalid_argument("Transfer amount must be positive.");
+        if (&toAccount == this) throw std::invalid_argument("Cannot transfer to the same account.");
+
+        bool thisFirst = accountNumber != toAccount.accountNumber
+            ? accountNumber < toAccount.accountNumber
+            : std::less<const Account*>{}(this, &toAccount);
+        {
+            std::lock_guard<std::mutex> firstLock(thisFirst ? balanceMutex : toAccount.balanceMutex);
+            std::lock_guard<std::mutex> secondLock(thisFirst ? toAccount.balanceMutex : balanceMutex);
+
+            if (amount > balance) throw std::runtime_error("Insufficient balance.");
+            balance -= amount;
+            toAccount.balance += amount;
+        }
+
+        // Posted after both locks are released: post() waits while the console ring is full
+        ConsoleMessage() << ("$" + amount.toString() + " transferred successfully from Account " + std::to_string(accountNumber)
+            + " to Account " + std::to_string(toAccount.accountNumber) + "\n");
     }
 };
 
 // --- Derived Class for Savings Account ---
 class SavingsAccount : public Account {
 public:
-    SavingsAccount(const std::string& name, int accNumber, double initialBalance)
+    SavingsAccount(const std::string& name, int accNumber, Money initialBalance)
         : Account(name, accNumber, initialBalance) {}
 
     void displayBalance() const override {
-        std::cout << "Savings Account:\n";
+        ConsoleMessage() << "Savings Account:\n";
         Account::displayBalance();
     }
 };
@@ -76,76 +114,356 @@ public:
 // --- Derived Class for Checking Account ---
 class CheckingAccount : public Account {
 public:
-    CheckingAccount(const std::string& name, int accNumber, double initialBalance)
+    CheckingAccount(const std::string& name, int accNumber, Money initialBalance)
         : Account(name, accNumber, initialBalance) {}
 
     void displayBalance() const override {
-        std::cout << "Checking Account:\n";
+        ConsoleMessage() << "Checking Account:\n";
         Account::displayBalance();
     }
 };
 
 // --- Class for Bank, Managing Multiple Accounts ---
+// Handle to an account inside a Bank: its position in the bank's account array.
+// Handles stay valid for the lifetime of the bank because accounts are never removed.
+using AccountHandle = std::size_t;
+constexpr AccountHandle InvalidAccountHandle = static_cast<AccountHandle>(-1);
+
 class Bank {
     std::vector<std::shared_ptr<Account>> accounts;
 
+    // Open-addressing index (linear probing) from account number to handle.
+    // Capacity is a power of two and is kept at least twice the number of accounts.
+    std::vector<int> slotAccountNumbers;
+    std::vector<AccountHandle> slotHandles;
+
+    static std::size_t slotFor(int accNumber, std::size_t slotMask) {
+        std::uint64_t mixed = static_cast<std::uint64_t>(static_cast<std::uint32_t>(accNumber)) * 0x9E3779B97F4A7C15ull;
+        return static_cast<std::size_t>(mixed >> 32) & slotMask;
+    }
+
+    void insertIntoIndex(int accNumber, AccountHandle handle) {
+        std::size_t slotMask = slotHandles.size() - 1;
+        std::size_t slot = slotFor(accNumber, slotMask);
+        while (slotHandles[slot] != InvalidAccountHandle) {
+            slot = (slot + 1) & slotMask;
+        }
+        slotAccountNumbers[slot] = accNumber;
+        slotHandles[slot] = handle;
+    }
+
+    void rebuildIndex(std::size_t capacity) {
+        slotAccountNumbers.assign(capacity, 0);
+        slotHandles.assign(capacity, InvalidAccountHandle);
+        for (AccountHandle handle = 0; handle < accounts.size(); ++handle) {
+            insertIntoIndex(accounts[handle]->getAccountNumber(), handle);
+        }
+    }
+
 public:
     // Create and add a new account to the bank
-    void addAccount(const std::shared_ptr<Account>& account) {
+    AccountHandle addAccount(const std::shared_ptr<Account>& account) {
+        if (findAccount(account->getAccountNumber()) != InvalidAccountHandle) {
+            throw std::invalid_argument("Account number already exists.");
+        }
         accounts.push_back(account);
+        if (accounts.size() * 2 > slotHandles.size()) {
+            rebuildIndex(slotHandles.empty() ? 16 : slotHandles.size() * 2);
+        }
+        else {
+            insertIntoIndex(account->getAccountNumber(), accounts.size() - 1);
+        }
+        return accounts.size() - 1;
+    }
+
+    // Pre-size the account array and the index for a known number of accounts
+    void reserve(std::size_t accountCount) {
+        accounts.reserve(accountCount);
+        if (accountCount * 2 > slotHandles.size()) {
+            std::size_t capacity = 16;
+            while (capacity < accountCount * 2) capacity *= 2;
+            rebuildIndex(capacity);
+        }
+    }
+
+    // Find the handle of an account by account number, InvalidAccountHandle if there is none
+    AccountHandle findAccount(int accNumber) const {
+        if (slotHandles.empty()) return InvalidAccountHandle;
+
+        std::size_t slotMask = slotHandles.size() - 1;
+        std::size_t slot = slotFor(accNumber, slotMask);
+        while (slotHandles[slot] != InvalidAccountHandle) {
+            if (slotAccountNumbers[slot] == accNumber) return slotHandles[slot];
+            slot = (slot + 1) & slotMask;
+        }
+        return InvalidAccountHandle;
+    }
+
+    // Access an account through its handle, no reference counting involved
+    Account& getAccount(AccountHandle handle) const {
+        return *accounts[handle];
     }
 
     // Find account by account number
-    std::shared_ptr<Account> getAccountByNumber(int accNumber) {
+    std::shared_ptr<Account> getAccountByNumber(int accNumber) const {
+        AccountHandle handle = findAccount(accNumber);
+        return handle != InvalidAccountHandle ? accounts[handle] : nullptr;
+    }
+
+    // Sum of all balances, exact because it adds whole cents. Each account is read under its own lock, so the
+    // sum is only a consistent total while no transfer is running: one in flight may be counted on both sides.
+    Money getTotalBalance() const {
+        std::int64_t totalCents = 0;
         for (const auto& account : accounts) {
-            if (account->getAccountNumber() == accNumber) {
-                return account;
-            }
+            totalCents += account->getBalance().toCents();
         }
-        return nullptr;
+        return Money::fromCents(totalCents);
     }
 
     // Display all accounts
     void displayAllAccounts() const {
-        std::cout << "Bank Accounts:\n";
+        ConsoleMessage() << "Bank Accounts:\n";
         for (const auto& account : accounts) {
             account->displayBalance();
-            std::cout << "-------------------\n";
+            ConsoleMessage() << "-------------------\n";
         }
+        ConsoleMessage() << "Total Balance: $" << getTotalBalance() << '\n';
     }
 };
 
+// --- Benchmarks, run with --benchmark ---
+// Random account lookups in a bank of accountCount accounts: through the hash index by handle, through
+// getAccountByNumber (a shared_ptr copy per lookup) and, on a small sample, through a linear scan of the
+// account array the way getAccountByNumber worked before the index.
+void runLookupBenchmark(std::size_t accountCount, std::size_t lookupCount) {
+    Bank bank;
+    bank.reserve(accountCount);
+    std::vector<std::shared_ptr<Account>> scanned;
+    scanned.reserve(accountCount);
+    for (std::size_t i = 0; i < accountCount; ++i) {
+        scanned.push_back(std::make_shared<SavingsAccount>("Benchmark Holder", static_cast<int>(100000 + i), Money::fromCents(10000)));
+        bank.addAccount(scanned.back());
+    }
+
+    std::mt19937 random(42);
+    std::vector<int> numbers(lookupCount);
+    for (int& number : numbers) number = 100000 + static_cast<int>(random() % accountCount);
+
+    // Runs lookup on the first count numbers and prints lookups per second; the checksum keeps the work alive
+    auto timeLookups = [&numbers](const char* path, std::size_t count, auto lookup) {
+        std::int64_t checksum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < count; ++i) checksum += lookup(numbers[i]);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "  " << path << ": " << count << " lookups in " << seconds << " s, "
+            << static_cast<long long>(count / seconds) << " lookups/sec (checksum " << checksum << ")\n";
+    };
+
+    std::cout << "Account lookups in a bank of " << accountCount << " accounts:\n";
+    timeLookups("findAccount + getAccount", lookupCount, [&bank](int number) {
+        return bank.getAccount(bank.findAccount(number)).getAccountNumber();
+    });
+    timeLookups("getAccountByNumber      ", lookupCount, [&bank](int number) {
+        return bank.getAccountByNumber(number)->getAccountNumber();
+    });
+    timeLookups("linear scan             ", std::min<std::size_t>(lookupCount, 200), [&scanned](int number) {
+        for (const auto& account : scanned) {
+            if (account->getAccountNumber() == number) return account->getAccountNumber();
+        }
+        return 0;
+    });
+}
+
+// Transfers between random pairs of accountCount accounts from threadCount threads at once, transferCount in all.
+// Returns false if the bank total changed; transfersPerSecond receives the measured rate.
+bool runTransferStress(unsigned threadCount, std::size_t accountCount, std::size_t transferCount, double& transfersPerSecond) {
+    Bank bank;
+    bank.reserve(accountCount);
+    for (std::size_t i = 0; i < accountCount; ++i) {
+        bank.addAccount(std::make_shared<CheckingAccount>("Stress Holder", static_cast<int>(1 + i), Money::fromCents(100000)));
+    }
+    Money totalBefore = bank.getTotalBalance();
+
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned thread = 0; thread < threadCount; ++thread) {
+        threads.emplace_back([&bank, accountCount, transferCount, threadCount, thread] {
+            std::mt19937 random(thread + 1);
+            for (std::size_t i = thread; i < transferCount; i += threadCount) {
+                AccountHandle from = random() % accountCount;
+                AccountHandle to = (from + 1 + random() % (accountCount - 1)) % accountCount;
+                try {
+                    bank.getAccount(from).transfer(bank.getAccount(to), Money::fromCents(1 + random() % 500));
+                }
+                catch (const std::runtime_error&) {
+                    // Insufficient balance: the transfer changed nothing
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    transfersPerSecond = transferCount / seconds;
+    return bank.getTotalBalance() == totalBefore;
+}
+
+// Transfer throughput as the thread count doubles, with the accounts spread out and with every thread
+// fighting over the same two accounts in both directions. Fails if any run changed the bank total.
+bool runTransferBenchmark(std::size_t transferCount) {
+    unsigned maxThreads = std::max(4u, std::thread::hardware_concurrency());
+    bool conserved = true;
+    std::cout << "\nConcurrent transfers, " << transferCount << " per run (transfers/sec), "
+        << std::thread::hardware_concurrency() << " hardware threads:\n";
+    std::cout << "  threads    1000 accounts       2 accounts\n";
+    for (unsigned threadCount = 1; threadCount <= maxThreads; threadCount *= 2) {
+        double spread, contended;
+        conserved &= runTransferStress(threadCount, 1000, transferCount, spread);
+        conserved &= runTransferStress(threadCount, 2, transferCount, contended);
+        std::cout << "  " << threadCount << "\t     " << static_cast<long long>(spread)
+            << "\t\t" << static_cast<long long>(contended) << "\n";
+    }
+    if (!conserved) {
+        std::cout << "FAILED: concurrent transfers changed the bank total\n";
+    }
+    return conserved;
+}
+
+// Deposits per second with each confirmation written to std::cout and flushed with std::endl as before the
+// async console, posted to the async console, and discarded in quiet mode. The async rate is given both as
+// the caller sees it and up to the point the writer thread has written everything. Console output goes to a
+// temporary file so the terminal does not set the pace.
+void runConsoleBenchmark(std::size_t depositCount) {
+    SavingsAccount account("Benchmark Holder", 1, Money::fromCents(0));
+    Money amount = Money::fromCents(100);
+    AsyncConsole& console = AsyncConsole::instance();
+    bool wasQuiet = console.isQuiet();
+
+    std::string outputPath = (std::filesystem::temp_directory_path() / "bank_console_benchmark.txt").string();
+    std::ofstream output(outputPath);
+    console.flush();
+    std::streambuf* previous = std::cout.rdbuf(output.rdbuf());
+
+    auto depositsPerSecond = [depositCount](std::chrono::steady_clock::time_point start) {
+        return static_cast<long long>(depositCount / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    };
+
+    console.setQuiet(true);
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < depositCount; ++i) {
+        account.deposit(amount);
+        std::cout << "$" << amount << " deposited successfully." << std::endl;
+    }
+    long long syncRate = depositsPerSecond(start);
+
+    console.setQuiet(false);
+    start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < depositCount; ++i) {
+        account.deposit(amount);
+    }
+    long long asyncPostRate = depositsPerSecond(start);
+    console.flush();
+    long long asyncWrittenRate = depositsPerSecond(start);
+
+    console.setQuiet(true);
+    start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < depositCount; ++i) {
+        account.deposit(amount);
+    }
+    long long quietRate = depositsPerSecond(start);
+
+    std::cout.rdbuf(previous);
+    console.setQuiet(wasQuiet);
+    output.close();
+    std::filesystem::remove(outputPath);
+
+    std::cout << "\nDeposits with a console message, " << depositCount << " per run (deposits/sec):\n"
+        << "  std::cout with std::endl   " << syncRate << "\n"
+        << "  async console, posted      " << asyncPostRate << "\n"
+        << "  async console, written     " << asyncWrittenRate << "\n"
+        << "  quiet                      " << quietRate << "\n";
+}
+
+int runBenchmarks() {
+    runLookupBenchmark(1000000, 10000000);
+    runConsoleBenchmark(1000000);
+
+    // Transfer messages would measure the console, not the locks
+    bool wasQuiet = AsyncConsole::instance().isQuiet();
+    AsyncConsole::instance().setQuiet(true);
+    bool conserved = runTransferBenchmark(2000000);
+    AsyncConsole::instance().setQuiet(wasQuiet);
+    return conserved ? 0 : 1;
+}
+
 // --- Main Function to Demonstrate the Banking System ---
-int main() {
+int main(int argc, char* argv[]) {
+    // Run with --quiet to discard console messages, or --benchmark to run the benchmarks instead of the demo
+    bool benchmark = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        if (argument == "--quiet") AsyncConsole::instance().setQuiet(true);
+        else if (argument == "--benchmark") benchmark = true;
+    }
+    if (benchmark) {
+        return runBenchmarks();
+    }
+
     // Create a bank object
     Bank bank;
 
     // Add savings and checking accounts to the bank
-    bank.addAccount(std::make_shared<SavingsAccount>("John Doe", 1001, 500.0));
-    bank.addAccount(std::make_shared<CheckingAccount>("Jane Smith", 1002, 1000.0));
+    bank.addAccount(std::make_shared<SavingsAccount>("John Doe", 1001, Money::fromDouble(500.0)));
+    bank.addAccount(std::make_shared<CheckingAccount>("Jane Smith", 1002, Money::fromDouble(1000.0)));
 
     // Display all accounts
     bank.displayAllAccounts();
 
     // Get John's account and deposit money
-    auto johnAccount = bank.getAccountByNumber(1001);
-    if (johnAccount) {
-        johnAccount->deposit(200);
-        johnAccount->displayBalance();
+    AccountHandle john = bank.findAccount(1001);
+    if (john != InvalidAccountHandle) {
+        bank.getAccount(john).deposit(Money::fromDouble(200.0));
+        bank.getAccount(john).displayBalance();
     }
 
     // Get Jane's account and withdraw money
-    auto janeAccount = bank.getAccountByNumber(1002);
-    if (janeAccount) {
-        janeAccount->withdraw(150);
-        janeAccount->displayBalance();
+    AccountHandle jane = bank.findAccount(1002);
+    if (jane != InvalidAccountHandle) {
+        bank.getAccount(jane).withdraw(Money::fromDouble(150.0));
+        bank.getAccount(jane).displayBalance();
     }
 
     // Transfer money from John's savings account to Jane's checking account
-    if (johnAccount && janeAccount) {
-        johnAccount->transfer(*janeAccount, 100);
-        johnAccount->displayBalance();
-        janeAccount->displayBalance();
+    if (john != InvalidAccountHandle && jane != InvalidAccountHandle) {
+        bank.getAccount(john).transfer(bank.getAccount(jane), Money::fromDouble(100.0));
+        bank.getAccount(john).displayBalance();
+        bank.getAccount(jane).displayBalance();
+    }
+
+    // Concurrent transfers in both directions between John and Jane; the bank total must not change
+    if (john != InvalidAccountHandle && jane != InvalidAccountHandle) {
+        Money totalBefore = bank.getTotalBalance();
+        std::vector<std::thread> tellers;
+        for (int teller = 0; teller < 4; ++teller) {
+            tellers.emplace_back([&bank, john, jane, teller] {
+                Account& from = bank.getAccount(teller % 2 == 0 ? john : jane);
+                Account& to = bank.getAccount(teller % 2 == 0 ? jane : john);
+                for (int i = 0; i < 3; ++i) {
+                    try {
+                        from.transfer(to, Money::fromDouble(25.0));
+                    }
+                    catch (const std::exception& e) {
+                        ConsoleMessage() << std::string("Transfer failed: ") + e.what() + "\n";
+                    }
+                }
+            });
+        }
+        for (auto& teller : tellers) teller.join();
+        if (bank.getTotalBalance() != totalBefore) {
+            ConsoleMessage() << "Error: concurrent transfers changed the bank total\n";
+            return 1;
+        }
+        ConsoleMessage() << "Total balance unchanged after concurrent transfers.\n";
     }
 
     // Display all accounts after transactions
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+
+// --- Async Console Output ---
+// Messages are queued in a fixed-size lock-free ring buffer and written to std::cout by one background thread,
+// so callers never wait on the console. Posting only blocks while the ring is full.
+// Shared by the console projects, include it as "../Common/AsyncConsole.h".
+class AsyncConsole {
+private:
+    static constexpr std::size_t capacity = 1024; // must be a power of two
+
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        std::string text;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<std::size_t> enqueuePosition{ 0 };
+    std::size_t dequeuePosition = 0; // only touched by the writer thread
+    std::atomic<std::size_t> postedCount{ 0 };
+    std::atomic<std::size_t> writtenCount{ 0 };
+    std::atomic<bool> quiet{ false };
+    std::atomic<bool> stopping{ false };
+    std::thread writer;
+
+    AsyncConsole() : slots(new Slot[capacity]) {
+        for (std::size_t i = 0; i < capacity; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        writer = std::thread(&AsyncConsole::run, this);
+    }
+
+    // Append the next queued message to batch. The slot keeps its buffer for the next message posted into it.
+    bool tryPop(std::string& batch) {
+        Slot& slot = slots[dequeuePosition & (capacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeuePosition + 1) {
+            return false;
+        }
+        batch += slot.text;
+        slot.text.clear();
+        slot.sequence.store(dequeuePosition + capacity, std::memory_order_release);
+        ++dequeuePosition;
+        return true;
+    }
+
+    // Writer thread: drain everything queued, write it with a single call, then sleep briefly when idle
+    void run() {
+        std::string batch;
+        while (true) {
+            bool stopRequested = stopping.load(std::memory_order_acquire);
+            std::size_t taken = 0;
+            while (tryPop(batch)) {
+                ++taken;
+            }
+
+            if (taken > 0) {
+                std::cout.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+                std::cout.flush();
+                batch.clear();
+                writtenCount.fetch_add(taken, std::memory_order_release);
+            }
+            else if (stopRequested) {
+                return;
+            }
+            else {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        }
+    }
+
+public:
+    AsyncConsole(const AsyncConsole&) = delete;
+    AsyncConsole& operator=(const AsyncConsole&) = delete;
+
+    // Writes out whatever is still queued before the program exits
+    ~AsyncConsole() {
+        stopping.store(true, std::memory_order_release);
+        writer.join();
+    }
+
+    static AsyncConsole& instance() {
+        static AsyncConsole console;
+        return console;
+    }
+
+    // In quiet mode messages are discarded instead of queued
+    void setQuiet(bool enabled) { quiet.store(enabled, std::memory_order_relaxed); }
+
+    bool isQuiet() const { return quiet.load(std::memory_order_relaxed); }
+
+    // Queue text for the writer thread; safe to call from any number of threads
+    void post(const std::string& text) {
+        post(text.data(), text.size());
+    }
+
+    // The characters are copied into the slot's own buffer, which is reused once the slot comes round again
+    void post(const char* text, std::size_t size) {
+        if (size == 0 || isQuiet()) return;
+
+        std::size_t position = enqueuePosition.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &slots[position & (capacity - 1)];
+            std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            if (sequence == position) {
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+            }
+            else if (sequence < position) {
+                // Ring is full: give the writer a chance to catch up
+                std::this_thread::yield();
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+            else {
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->text.assign(text, size);
+        postedCount.fetch_add(1, std::memory_order_relaxed);
+        slot->sequence.store(position + 1, std::memory_order_release);
+    }
+
+    // Block until every message posted so far has been written
+    void flush() {
+        std::size_t target = postedCount.load(std::memory_order_relaxed);
+        while (writtenCount.load(std::memory_order_acquire) < target) {
+            std::this_thread::yield();
+        }
+    }
+};
+
+// Drop-in replacement for a std::cout statement: collects the pieces with operator<<
+// and posts them to the async console as one message at the end of the statement.
+// Each thread formats into one reused buffer, so a message allocates nothing once the buffer has grown.
+// A message built while another is open on the same thread (a function called inside a << chain that
+// writes its own message) appends after it and takes only its own characters.
+class ConsoleMessage {
+private:
+    // Stream buffer that appends to a std::string
+    class AppendBuffer : public std::streambuf {
+    public:
+        std::string text;
+
+    protected:
+        int_type overflow(int_type character) override {
+            if (!traits_type::eq_int_type(character, traits_type::eof())) text += traits_type::to_char_type(character);
+            return traits_type::not_eof(character);
+        }
+
+        std::streamsize xsputn(const char* characters, std::streamsize count) override {
+            text.append(characters, static_cast<std::size_t>(count));
+            return count;
+        }
+    };
+
+    struct ThreadBuffer {
+        AppendBuffer buffer;
+        std::ostream stream{ &buffer };
+        std::ios_base::fmtflags defaultFlags = stream.flags();
+        std::streamsize defaultPrecision = stream.precision();
+    };
+
+    static ThreadBuffer& threadBuffer() {
+        thread_local ThreadBuffer buffer;
+        return buffer;
+    }
+
+    ThreadBuffer& buffer;
+    std::size_t start;
+
+public:
+    ConsoleMessage() : buffer(threadBuffer()), start(buffer.buffer.text.size()) {
+        if (start == 0) {
+            // Formatting set by an earlier message (std::fixed, std::hex, ...) does not carry over
+            buffer.stream.flags(buffer.defaultFlags);
+            buffer.stream.precision(buffer.defaultPrecision);
+            buffer.stream.fill(' ');
+        }
+    }
+
+    ConsoleMessage(const ConsoleMessage&) = delete;
+    ConsoleMessage& operator=(const ConsoleMessage&) = delete;
+
+    ~ConsoleMessage() {
+        std::string& text = buffer.buffer.text;
+        AsyncConsole::instance().post(text.data() + start, text.size() - start);
+        text.resize(start);
+    }
+
+    template <typename T>
+    ConsoleMessage& operator<<(const T& value) {
+        if (!AsyncConsole::instance().isQuiet()) buffer.stream << value;
+        return *this;
+    }
+};
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <string_view>
+#include <istream>
+#include <ostream>
+
+// --- Fixed-Point Money Value ---
+// Amounts are kept as a whole number of cents so sums and comparisons are exact.
+// Shared by the bank projects, include it as "../Common/Money.h".
+enum class RoundingMode { HalfUp, HalfEven, Down };
+
+class Money {
+    std::int64_t cents = 0;
+
+    static constexpr std::int64_t divideRounded(std::int64_t numerator, std::int64_t denominator, RoundingMode mode) {
+        std::int64_t quotient = numerator / denominator;
+        std::int64_t remainder = numerator % denominator;
+        std::int64_t twiceRemainder = remainder < 0 ? -2 * remainder : 2 * remainder;
+        std::int64_t step = numerator < 0 ? -1 : 1;
+
+        if (remainder == 0 || mode == RoundingMode::Down) return quotient;
+        if (twiceRemainder > denominator) return quotient + step;
+        if (twiceRemainder < denominator) return quotient;
+        return (mode == RoundingMode::HalfUp || quotient % 2 != 0) ? quotient + step : quotient;
+    }
+
+    static constexpr bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+public:
+    constexpr Money() = default;
+
+    static constexpr Money fromCents(std::int64_t minorUnits) {
+        Money money;
+        money.cents = minorUnits;
+        return money;
+    }
+
+    static Money fromDouble(double amount, RoundingMode mode = RoundingMode::HalfEven) {
+        double scaled = amount * 100.0;
+        if (mode == RoundingMode::Down) return fromCents(static_cast<std::int64_t>(std::trunc(scaled)));
+        if (mode == RoundingMode::HalfUp) return fromCents(std::llround(scaled));
+        return fromCents(static_cast<std::int64_t>(std::nearbyint(scaled)));
+    }
+
+    // Reads "123", "-12.5" or "100.500000" exactly; digits after the cents are rounded with mode
+    static bool parse(std::string_view text, Money& amount, RoundingMode mode = RoundingMode::HalfEven) {
+        size_t i = 0;
+        bool negative = false;
+        if (i < text.size() && (text[i] == '-' || text[i] == '+')) negative = text[i++] == '-';
+
+        std::int64_t minorUnits = 0;
+        int digitCount = 0;
+        while (i < text.size() && isDigit(text[i])) {
+            minorUnits = minorUnits * 10 + (text[i++] - '0');
+            ++digitCount;
+        }
+
+        int fractionDigits = 0;
+        int firstDropped = 0;
+        bool moreDropped = false;
+        if (i < text.size() && text[i] == '.') {
+            ++i;
+            while (i < text.size() && isDigit(text[i])) {
+                int digit = text[i++] - '0';
+                if (fractionDigits < 2) minorUnits = minorUnits * 10 + digit;
+                else if (fractionDigits == 2) firstDropped = digit;
+                else if (digit != 0) moreDropped = true;
+                ++fractionDigits;
+                ++digitCount;
+            }
+        }
+        if (digitCount == 0 || digitCount - fractionDigits > 16 || i != text.size()) return false;
+
+        for (; fractionDigits < 2; ++fractionDigits) minorUnits *= 10;
+        bool roundsAway = mode != RoundingMode::Down && firstDropped >= 5
+            && (firstDropped > 5 || moreDropped || mode == RoundingMode::HalfUp || minorUnits % 2 != 0);
+        if (roundsAway) ++minorUnits;
+
+        amount = fromCents(negative ? -minorUnits : minorUnits);
+        return true;
+    }
+
+    constexpr std::int64_t toCents() const { return cents; }
+    double toDouble() const { return cents / 100.0; }
+    constexpr bool isPositive() const { return cents > 0; }
+
+    // Percentage given in basis points (1% = 100), rounded back to whole cents
+    constexpr Money applyRate(std::int64_t basisPoints, RoundingMode mode = RoundingMode::HalfEven) const {
+        return fromCents(divideRounded(cents * basisPoints, 10000, mode));
+    }
+
+    constexpr Money operator+(Money other) const { return fromCents(cents + other.cents); }
+    constexpr Money operator-(Money other) const { return fromCents(cents - other.cents); }
+    constexpr Money operator-() const { return fromCents(-cents); }
+    constexpr Money operator*(std::int64_t factor) const { return fromCents(cents * factor); }
+    Money& operator+=(Money other) { cents += other.cents; return *this; }
+    Money& operator-=(Money other) { cents -= other.cents; return *this; }
+
+    constexpr bool operator==(Money other) const { return cents == other.cents; }
+    constexpr bool operator!=(Money other) const { return cents != other.cents; }
+    constexpr bool operator<(Money other) const { return cents < other.cents; }
+    constexpr bool operator<=(Money other) const { return cents <= other.cents; }
+    constexpr bool operator>(Money other) const { return cents > other.cents; }
+    constexpr bool operator>=(Money other) const { return cents >= other.cents; }
+
+    std::string toString() const {
+        char buffer[24];
+        char* end = buffer + sizeof(buffer);
+        char* digits = end;
+        std::uint64_t value = cents < 0 ? 0 - static_cast<std::uint64_t>(cents) : static_cast<std::uint64_t>(cents);
+
+        *--digits = static_cast<char>('0' + value % 10); value /= 10;
+        *--digits = static_cast<char>('0' + value % 10); value /= 10;
+        *--digits = '.';
+        do {
+            *--digits = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+        if (cents < 0) *--digits = '-';
+
+        return std::string(digits, end);
+    }
+
+    friend std::ostream& operator<<(std::ostream& out, Money money) {
+        return out << money.toString();
+    }
+
+    friend std::istream& operator>>(std::istream& in, Money& money) {
+        std::string text;
+        if (in >> text && !parse(text, money)) in.setstate(std::ios::failbit);
+        return in;
+    }
+};
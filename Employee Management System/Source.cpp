@@ -4,6 +4,9 @@
 #include <memory>
 #include <stdexcept>
 #include <map>
+
+#include "../Common/AsyncConsole.h"
+
 using namespace std;
 
 // --- Abstract Employee Class ---
@@ -20,9 +23,9 @@ public:
     virtual ~Employee() = default;
 
     virtual void displayDetails() const {
-        std::cout << "Employee ID: " << id
+        ConsoleMessage() << "Employee ID: " << id
             << "\nName: " << name
-            << "\nBase Salary: $" << baseSalary << std::endl;
+            << "\nBase Salary: $" << baseSalary << '\n';
     }
 
     int getId() const { return id; }
@@ -35,7 +38,7 @@ public:
 
     virtual void promote(double increment) {
         baseSalary += increment;
-        std::cout << name << " promoted with a salary increment of $" << increment << std::endl;
+        ConsoleMessage() << name << " promoted with a salary increment of $" << increment << '\n';
     }
 };
 
@@ -49,9 +52,9 @@ public:
         : Employee(empName, empID, salary), bonus(empBonus) {}
 
     void displayDetails() const override {
-        std::cout << "Full-Time Employee:\n";
+        ConsoleMessage() << "Full-Time Employee:\n";
         Employee::displayDetails();
-        std::cout << "Bonus: $" << bonus << std::endl;
+        ConsoleMessage() << "Bonus: $" << bonus << '\n';
     }
 
     double calculateSalary() const override {
@@ -72,10 +75,10 @@ public:
         : Employee(empName, empID, 0), hourlyRate(rate), hoursWorked(hours) {}
 
     void displayDetails() const override {
-        std::cout << "Part-Time Employee:\n";
+        ConsoleMessage() << "Part-Time Employee:\n";
         Employee::displayDetails();
-        std::cout << "Hourly Rate: $" << hourlyRate
-            << "\nHours Worked: " << hoursWorked << std::endl;
+        ConsoleMessage() << "Hourly Rate: $" << hourlyRate
+            << "\nHours Worked: " << hoursWorked << '\n';
     }
 
     double calculateSalary() const override {
@@ -98,25 +101,25 @@ public:
 
     void addEmployee(const std::shared_ptr<Employee>& employee) {
         employees.push_back(employee);
-        std::cout << "Employee " << employee->getName() << " added to " << departmentName << " department.\n";
+        ConsoleMessage() << "Employee " << employee->getName() << " added to " << departmentName << " department.\n";
     }
 
     void removeEmployee(int empID) {
         for (auto it = employees.begin(); it != employees.end(); ++it) {
             if ((*it)->getId() == empID) {
-                std::cout << "Employee " << (*it)->getName() << " removed from " << departmentName << " department.\n";
+                ConsoleMessage() << "Employee " << (*it)->getName() << " removed from " << departmentName << " department.\n";
                 employees.erase(it);
                 return;
             }
         }
-        std::cout << "Employee ID " << empID << " not found in " << departmentName << " department.\n";
+        ConsoleMessage() << "Employee ID " << empID << " not found in " << departmentName << " department.\n";
     }
 
     void displayDepartmentDetails() const {
-        std::cout << "Department: " << departmentName << "\nEmployees:\n";
+        ConsoleMessage() << "Department: " << departmentName << "\nEmployees:\n";
         for (const auto& employee : employees) {
             employee->displayDetails();
-            std::cout << "-------------------\n";
+            ConsoleMessage() << "-------------------\n";
         }
     }
 };
@@ -134,9 +137,9 @@ public:
         double tax = calculateTax(salary);
         double netSalary = salary - tax;
 
-        std::cout << "Salary for " << employee.getName() << ": $" << salary
+        ConsoleMessage() << "Salary for " << employee.getName() << ": $" << salary
             << "\nTax Deduction: $" << tax
-            << "\nNet Salary: $" << netSalary << std::endl;
+            << "\nNet Salary: $" << netSalary << '\n';
     }
 };
 
@@ -150,19 +153,19 @@ public:
     // Add an employee to the system
     void addEmployee(const std::shared_ptr<Employee>& employee) {
         allEmployees.push_back(employee);
-        std::cout << "Employee " << employee->getName() << " added to the system.\n";
+        ConsoleMessage() << "Employee " << employee->getName() << " added to the system.\n";
     }
 
     // Remove an employee by ID
     void removeEmployee(int empID) {
         for (auto it = allEmployees.begin(); it != allEmployees.end(); ++it) {
             if ((*it)->getId() == empID) {
-                std::cout << "Employee " << (*it)->getName() << " removed from the system.\n";
+                ConsoleMessage() << "Employee " << (*it)->getName() << " removed from the system.\n";
                 allEmployees.erase(it);
                 return;
             }
         }
-        std::cout << "Employee ID " << empID << " not found in the system.\n";
+        ConsoleMessage() << "Employee ID " << empID << " not found in the system.\n";
     }
 
     // Update an employee's details (promote with a salary increase)
@@ -173,13 +176,13 @@ public:
                 return;
             }
         }
-        std::cout << "Employee ID " << empID << " not found.\n";
+        ConsoleMessage() << "Employee ID " << empID << " not found.\n";
     }
 
     // Add department to the system
     void addDepartment(const std::string& departmentName) {
         departments[departmentName] = std::make_shared<Department>(departmentName);
-        std::cout << "Department " << departmentName << " created.\n";
+        ConsoleMessage() << "Department " << departmentName << " created.\n";
     }
 
     // Assign an employee to a department
@@ -191,15 +194,15 @@ public:
                 return;
             }
         }
-        std::cout << "Employee ID " << empID << " not found.\n";
+        ConsoleMessage() << "Employee ID " << empID << " not found.\n";
     }
 
     // Display all employee details
     void displayAllEmployees() const {
-        std::cout << "All Employees:\n";
+        ConsoleMessage() << "All Employees:\n";
         for (const auto& employee : allEmployees) {
             employee->displayDetails();
-            std::cout << "-------------------\n";
+            ConsoleMessage() << "-------------------\n";
         }
     }
 
@@ -207,7 +210,7 @@ public:
     /*void displayAllDepartments() const {
         for (const auto& [name, department] : departments) {
             department->displayDepartmentDetails();
-            std::cout << "===================\n";
+            ConsoleMessage() << "===================\n";
         }
     }*/
 
@@ -219,12 +222,17 @@ public:
                 return;
             }
         }
-        std::cout << "Employee ID " << empID << " not found.\n";
+        ConsoleMessage() << "Employee ID " << empID << " not found.\n";
     }
 };
 
 // --- Main Function to Demonstrate the System ---
-int main() {
+int main(int argc, char* argv[]) {
+    // Run with --quiet to discard console messages
+    if (argc > 1 && std::string(argv[1]) == "--quiet") {
+        AsyncConsole::instance().setQuiet(true);
+    }
+
     EmployeeManagementSystem system;
 
     // Create departments
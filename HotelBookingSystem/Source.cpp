@@ -5,6 +5,8 @@
 #include <stdexcept>
 #include <map>
 
+#include "../Common/AsyncConsole.h"
+
 // --- Room Class ---
 class Room {
 private:
@@ -34,8 +36,8 @@ public:
     }
 
     void displayRoomDetails() const {
-        std::cout << "Room " << roomNumber << ": $" << pricePerNight
-            << " per night, " << (available ? "Available" : "Booked") << std::endl;
+        ConsoleMessage() << "Room " << roomNumber << ": $" << pricePerNight
+            << " per night, " << (available ? "Available" : "Booked") << '\n';
     }
 };
 
@@ -58,19 +60,19 @@ public:
     }
 
     void displayCustomerDetails() const {
-        std::cout << "Customer: " << name << "\nEmail: " << email << "\nPhone: " << phone << std::endl;
+        ConsoleMessage() << "Customer: " << name << "\nEmail: " << email << "\nPhone: " << phone << '\n';
     }
 
     void displayBookingHistory() const {
-        std::cout << "Booking History for " << name << ": ";
+        ConsoleMessage() << "Booking History for " << name << ": ";
         if (bookingHistory.empty()) {
-            std::cout << "No previous bookings.\n";
+            ConsoleMessage() << "No previous bookings.\n";
         }
         else {
             for (const auto& room : bookingHistory) {
-                std::cout << "Room " << room << " ";
+                ConsoleMessage() << "Room " << room << " ";
             }
-            std::cout << std::endl;
+            ConsoleMessage() << '\n';
         }
     }
 };
@@ -98,8 +100,8 @@ public:
         : Payment(amt), cardNumber(cardNum) {}
 
     void processPayment() const override {
-        std::cout << "Processing credit card payment of $" << amount
-            << " using card number: " << cardNumber << std::endl;
+        ConsoleMessage() << "Processing credit card payment of $" << amount
+            << " using card number: " << cardNumber << '\n';
     }
 };
 
@@ -113,8 +115,8 @@ public:
         : Payment(amt), paypalEmail(email) {}
 
     void processPayment() const override {
-        std::cout << "Processing PayPal payment of $" << amount
-            << " using PayPal email: " << paypalEmail << std::endl;
+        ConsoleMessage() << "Processing PayPal payment of $" << amount
+            << " using PayPal email: " << paypalEmail << '\n';
     }
 };
 
@@ -136,8 +138,8 @@ public:
         if (room->isAvailable()) {
             room->bookRoom();
             customer->addBookingToHistory(room->getRoomNumber());
-            std::cout << "Booking successful! " << customer->getName() << " has booked room "
-                << room->getRoomNumber() << " for " << nights << " night(s). Total cost: $" << totalCost << std::endl;
+            ConsoleMessage() << "Booking successful! " << customer->getName() << " has booked room "
+                << room->getRoomNumber() << " for " << nights << " night(s). Total cost: $" << totalCost << '\n';
         }
         else {
             throw std::runtime_error("Room is not available.");
@@ -155,13 +157,13 @@ public:
     // Add a room to the hotel
     void addRoom(int roomNumber, double pricePerNight) {
         rooms.push_back(std::make_shared<Room>(roomNumber, pricePerNight));
-        std::cout << "Room " << roomNumber << " added with price $" << pricePerNight << " per night.\n";
+        ConsoleMessage() << "Room " << roomNumber << " added with price $" << pricePerNight << " per night.\n";
     }
 
     // Add a customer to the system
     void addCustomer(const std::string& name, const std::string& email, const std::string& phone) {
         customers.push_back(std::make_shared<Customer>(name, email, phone));
-        std::cout << "Customer " << name << " added to the system.\n";
+        ConsoleMessage() << "Customer " << name << " added to the system.\n";
     }
 
     // Find a room by room number
@@ -186,7 +188,7 @@ public:
 
     // Display all room details
     void displayAllRooms() const {
-        std::cout << "Room List:\n";
+        ConsoleMessage() << "Room List:\n";
         for (const auto& room : rooms) {
             room->displayRoomDetails();
         }
@@ -194,7 +196,7 @@ public:
 
     // Display all customer details
     void displayAllCustomers() const {
-        std::cout << "Customer List:\n";
+        ConsoleMessage() << "Customer List:\n";
         for (const auto& customer : customers) {
             customer->displayCustomerDetails();
         }
@@ -215,7 +217,12 @@ public:
 };
 
 // --- Main Function to Demonstrate the System ---
-int main() {
+int main(int argc, char* argv[]) {
+    // Run with --quiet to discard console messages
+    if (argc > 1 && std::string(argv[1]) == "--quiet") {
+        AsyncConsole::instance().setQuiet(true);
+    }
+
     HotelManagementSystem system;
 
     // Add rooms to the system
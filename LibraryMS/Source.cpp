@@ -3,6 +3,9 @@
 #include <string>
 #include <memory>
 #include <stdexcept>
+#include <algorithm>
+
+#include "../Common/AsyncConsole.h"
 
 // --- Book Class ---
 class Book {
@@ -33,8 +36,8 @@ public:
     }
 
     void displayDetails() const {
-        std::cout << "Title: " << title << ", Author: " << author << ", ISBN: " << isbn
-            << ", " << (available ? "Available" : "Not Available") << std::endl;
+        ConsoleMessage() << "Title: " << title << ", Author: " << author << ", ISBN: " << isbn
+            << ", " << (available ? "Available" : "Not Available") << '\n';
     }
 };
 
@@ -58,15 +61,15 @@ public:
     virtual void returnBook(const std::shared_ptr<Book>& book) = 0;
 
     void displayBorrowedBooks() const {
-        std::cout << "Borrowed Books by " << name << ": ";
+        ConsoleMessage() << "Borrowed Books by " << name << ": ";
         if (borrowedBooks.empty()) {
-            std::cout << "No books borrowed.\n";
+            ConsoleMessage() << "No books borrowed.\n";
         }
         else {
             for (const auto& book : borrowedBooks) {
-                std::cout << book << " ";
+                ConsoleMessage() << book << " ";
             }
-            std::cout << std::endl;
+            ConsoleMessage() << '\n';
         }
     }
 
@@ -90,10 +93,10 @@ public:
         if (book->isAvailable()) {
             book->borrowBook();
             addBorrowedBook(book->getIsbn());
-            std::cout << name << " borrowed \"" << book->getTitle() << "\"." << std::endl;
+            ConsoleMessage() << name << " borrowed \"" << book->getTitle() << "\"." << '\n';
         }
         else {
-            std::cout << "Book \"" << book->getTitle() << "\" is not available." << std::endl;
+            ConsoleMessage() << "Book \"" << book->getTitle() << "\" is not available." << '\n';
         }
     }
 
@@ -101,10 +104,10 @@ public:
         if (std::find(borrowedBooks.begin(), borrowedBooks.end(), book->getIsbn()) != borrowedBooks.end()) {
             book->returnBook();
             removeBorrowedBook(book->getIsbn());
-            std::cout << name << " returned \"" << book->getTitle() << "\"." << std::endl;
+            ConsoleMessage() << name << " returned \"" << book->getTitle() << "\"." << '\n';
         }
         else {
-            std::cout << "This book was not borrowed by " << name << "." << std::endl;
+            ConsoleMessage() << "This book was not borrowed by " << name << "." << '\n';
         }
     }
 };
@@ -119,10 +122,10 @@ public:
         if (book->isAvailable()) {
             book->borrowBook();
             addBorrowedBook(book->getIsbn());
-            std::cout << name << " borrowed \"" << book->getTitle() << "\"." << std::endl;
+            ConsoleMessage() << name << " borrowed \"" << book->getTitle() << "\"." << '\n';
         }
         else {
-            std::cout << "Book \"" << book->getTitle() << "\" is not available." << std::endl;
+            ConsoleMessage() << "Book \"" << book->getTitle() << "\" is not available." << '\n';
         }
     }
 
@@ -130,19 +133,19 @@ public:
         if (std::find(borrowedBooks.begin(), borrowedBooks.end(), book->getIsbn()) != borrowedBooks.end()) {
             book->returnBook();
             removeBorrowedBook(book->getIsbn());
-            std::cout << name << " returned \"" << book->getTitle() << "\"." << std::endl;
+            ConsoleMessage() << name << " returned \"" << book->getTitle() << "\"." << '\n';
         }
         else {
-            std::cout << "This book was not borrowed by " << name << "." << std::endl;
+            ConsoleMessage() << "This book was not borrowed by " << name << "." << '\n';
         }
     }
 
     void addBook(const std::shared_ptr<Book>& book) {
-        std::cout << "Book \"" << book->getTitle() << "\" added to the library." << std::endl;
+        ConsoleMessage() << "Book \"" << book->getTitle() << "\" added to the library." << '\n';
     }
 
     void removeBook(const std::shared_ptr<Book>& book) {
-        std::cout << "Book \"" << book->getTitle() << "\" removed from the library." << std::endl;
+        ConsoleMessage() << "Book \"" << book->getTitle() << "\" removed from the library." << '\n';
     }
 };
 
@@ -156,19 +159,19 @@ public:
     // Add a book to the library
     void addBook(const std::string& title, const std::string& author, const std::string& isbn) {
         books.push_back(std::make_shared<Book>(title, author, isbn));
-        std::cout << "Book \"" << title << "\" added to the library." << std::endl;
+        ConsoleMessage() << "Book \"" << title << "\" added to the library." << '\n';
     }
 
     // Remove a book from the library
     void removeBook(const std::string& isbn) {
-        auto it = std::remove_if(books.begin(), books.end(),
+        auto it = std::find_if(books.begin(), books.end(),
             [&isbn](const std::shared_ptr<Book>& book) { return book->getIsbn() == isbn; });
         if (it != books.end()) {
-            std::cout << "Book \"" << (*it)->getTitle() << "\" removed from the library." << std::endl;
-            books.erase(it, books.end());
+            ConsoleMessage() << "Book \"" << (*it)->getTitle() << "\" removed from the library." << '\n';
+            books.erase(it);
         }
         else {
-            std::cout << "Book with ISBN " << isbn << " not found." << std::endl;
+            ConsoleMessage() << "Book with ISBN " << isbn << " not found." << '\n';
         }
     }
 
@@ -176,11 +179,11 @@ public:
     void registerMember(const std::string& name, const std::string& memberId, bool isLibrarian = false) {
         if (isLibrarian) {
             members.push_back(std::make_shared<Librarian>(name, memberId));
-            std::cout << "Librarian " << name << " registered." << std::endl;
+            ConsoleMessage() << "Librarian " << name << " registered." << '\n';
         }
         else {
             members.push_back(std::make_shared<Student>(name, memberId));
-            std::cout << "Student " << name << " registered." << std::endl;
+            ConsoleMessage() << "Student " << name << " registered." << '\n';
         }
     }
 
@@ -200,7 +203,7 @@ public:
 
     // Display all books
     void displayAllBooks() const {
-        std::cout << "Books in the Library:\n";
+        ConsoleMessage() << "Books in the Library:\n";
         for (const auto& book : books) {
             book->displayDetails();
         }
@@ -208,9 +211,9 @@ public:
 
     // Display all members
     void displayAllMembers() const {
-        std::cout << "Library Members:\n";
+        ConsoleMessage() << "Library Members:\n";
         for (const auto& member : members) {
-            std::cout << member->getName() << " (ID: " << member->getMemberId() << ")" << std::endl;
+            ConsoleMessage() << member->getName() << " (ID: " << member->getMemberId() << ")" << '\n';
             member->displayBorrowedBooks();
         }
     }
@@ -238,7 +241,12 @@ private:
 };
 
 // --- Main Function to Demonstrate the System ---
-int main() {
+int main(int argc, char* argv[]) {
+    // Run with --quiet to discard console messages
+    if (argc > 1 && std::string(argv[1]) == "--quiet") {
+        AsyncConsole::instance().setQuiet(true);
+    }
+
     LibraryManagementSystem library;
 
     // Adding books to the library